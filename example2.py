@@ -61,32 +61,21 @@ def main():
     resolution = 1  # meters per pixel (assumed)
     print(dim)
 
-    map_data = []
-    # transform image to map data, for each pixel, if the value is over 200, it is marked as 100 occipied, otherwise 0 free
-    for r in range(dim[1]):  # rows (y)
-        row_data = []
-        for c in range(dim[0]):  # cols (x)
-            pixel_value = img[r, c]
-            if isinstance(pixel_value, np.ndarray):
-                # If pixel is multi-channel (e.g., RGB), take the first channel
-                pixel_value = pixel_value[0]
-            if pixel_value > 200:  # Assuming a threshold for occupied
-                row_data.append(1)  # Occupied
-            else:
-                row_data.append(0)
-        map_data.extend(row_data)
+    # transform image to map data, pixels over 200 are occupied (1), the others free (0).
+    # The planner reads this int8 array in place, so there is no need to build a list.
+    map_data = (img > 200).astype(np.int8).ravel()
 
     # random pick start and goal points that are free and at least 1000 pixels apart
-    free_indices = [i for i, v in enumerate(map_data) if v == 0]
+    free_indices = np.flatnonzero(map_data == 0)
     print(f"Number of free cells: {len(free_indices)}")
     if len(free_indices) < 2:
         print("Not enough free cells to pick start and goal points.")
         return
     import random
-    start_index = random.choice(free_indices)
-    goal_index = random.choice(free_indices)
+    start_index = int(random.choice(free_indices))
+    goal_index = int(random.choice(free_indices))
     while abs(start_index - goal_index) < 1000:  # Ensure at least 1000 pixels apart
-        goal_index = random.choice(free_indices)
+        goal_index = int(random.choice(free_indices))
     print(f"Start index: {start_index}, Goal index: {goal_index}")
     print(f"Start cell value: {map_data[start_index]}, Goal cell value: {map_data[goal_index]}")
 
@@ -160,17 +149,13 @@ def main():
     ax.scatter([start_w[0]], [start_w[1]], c='lime', s=80, marker='o', label='Start')
     ax.scatter([goal_w[0]], [goal_w[1]], c='red', s=80, marker='o', label='Goal')
 
-    # Draw A* path (blue)
-    if status_astar == 0 and path_astar:
-        path_astar_x = [pt[0] for pt in path_astar]
-        path_astar_y = [pt[1] for pt in path_astar]
-        ax.plot(path_astar_x, path_astar_y, color='blue', linewidth=2, label="A* Path")
+    # Draw A* path (blue), paths are (N, 2) arrays of [x, y]
+    if status_astar == 0 and len(path_astar):
+        ax.plot(path_astar[:, 0], path_astar[:, 1], color='blue', linewidth=2, label="A* Path")
 
     # Draw Theta* path (magenta)
-    if status_theta == 0 and path_theta:
-        path_theta_x = [pt[0] for pt in path_theta]
-        path_theta_y = [pt[1] for pt in path_theta]
-        ax.plot(path_theta_x, path_theta_y, color='magenta', linewidth=2, label="Theta* Path")
+    if status_theta == 0 and len(path_theta):
+        ax.plot(path_theta[:, 0], path_theta[:, 1], color='magenta', linewidth=2, label="Theta* Path")
 
     ax.legend()
     ax.set_title("Planned Path")
@@ -0,0 +1,95 @@
+import sys
+import os
+import time
+import random
+
+# Same module lookup as example.py: the current directory and the usual CMake build directories
+sys.path.insert(0, os.path.abspath("."))
+for candidate_dir in ['build', 'build/Debug', 'build/Release', 'build/RelWithDebInfo', 'build/MinSizeRel']:
+    abs_candidate_dir = os.path.abspath(candidate_dir)
+    if os.path.isdir(abs_candidate_dir):
+        sys.path.insert(0, abs_candidate_dir)
+
+try:
+    import numpy as np
+    import ThetaStarPlanner
+except ImportError as e:
+    print(f"Error importing ThetaStarPlanner or numpy: {e}")
+    print("Please build the module first (see README.md) and make sure it is in your PYTHONPATH.")
+    exit(1)
+
+
+# Checks that A* with landmarks finds paths as short as plain A* on a large map. Raises AssertionError on the
+# first longer path, so the script exits with a non-zero status. Paths on a serpentine map wind back and forth
+# over the whole grid, so the landmark distances get much longer than on open maps.
+
+def check(condition, message):
+    if not condition:
+        raise AssertionError(message)
+
+
+# Walls across every fifth row with a gap at alternating ends and 10% random obstacles. The rows in the middle
+# of the corridors stay free, so the corridors stay connected
+def make_serpentine(size, seed):
+    rng = random.Random(seed)
+    grid = np.zeros((size, size), dtype=np.int8)
+    for r in range(size):
+        for c in range(size):
+            if rng.random() < 0.1:
+                grid[r, c] = 1
+    grid[2::5, :] = 0
+    for r in range(4, size, 5):
+        gap = 1 if (r // 5) % 2 else size - 3
+        grid[r, :] = 1
+        grid[r, gap - 1:gap + 2] = 0
+    return grid
+
+
+def make_queries(grid, count, seed):
+    rng = random.Random(seed)
+    free = np.argwhere(grid == 0)
+    starts, goals = [], []
+    for _ in range(count):
+        (sr, sc), (gr, gc) = free[rng.randrange(len(free))], free[rng.randrange(len(free))]
+        starts.append([sc + 0.5, sr + 0.5])
+        goals.append([gc + 0.5, gr + 0.5])
+    return np.array(starts), np.array(goals)
+
+
+# Length of a path of cell centres, each step costs 1 or sqrt(2)
+def path_length(path):
+    if len(path) < 2:
+        return 0.0
+    return float(np.sum(np.hypot(np.diff(path[:, 0]), np.diff(path[:, 1]))))
+
+
+def check_landmarks(size, num_queries, landmarks, num_threads):
+    grid = make_serpentine(size, 1)
+    starts, goals = make_queries(grid, num_queries, 2)
+    planner = ThetaStarPlanner.Planner([0.0, 0.0], [size, size], grid, 1.0)
+    options = dict(searchtype="astar", metrictype="diagonal", cutcorners=False)
+
+    begin = time.perf_counter()
+    expected = planner.plan_many(starts, goals, threads=num_threads, **options)
+    plain = time.perf_counter() - begin
+    begin = time.perf_counter()
+    results = planner.plan_many(starts, goals, threads=num_threads, landmarks=landmarks, **options)
+    alt = time.perf_counter() - begin
+
+    for k in range(num_queries):
+        (status1, path1, _), (status2, path2, _) = expected[k], results[k]
+        check(status1 == status2, f"query {k}: status {status2} with landmarks, {status1} without")
+        length1, length2 = path_length(path1), path_length(path2)
+        check(length2 <= length1 + 1e-6 * max(1.0, length1),
+              f"query {k}: path of {length2:.3f} with landmarks, {length1:.3f} without")
+    print(f"{size}x{size}, {num_queries} queries, {landmarks} landmarks: A* {plain * 1000:.0f} ms, "
+          f"with landmarks {alt * 1000:.0f} ms (table included), all paths as short")
+
+
+def main(size=1000):
+    check_landmarks(size, 60, 8, 8)
+    print("All landmark paths are as short as the A* ones")
+
+
+if __name__ == "__main__":
+    main(size=int(sys.argv[1]) if len(sys.argv) > 1 else 1000)
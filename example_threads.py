@@ -0,0 +1,136 @@
+import sys
+import os
+import time
+import random
+import threading
+
+# Same module lookup as example.py: the current directory and the usual CMake build directories
+sys.path.insert(0, os.path.abspath("."))
+for candidate_dir in ['build', 'build/Debug', 'build/Release', 'build/RelWithDebInfo', 'build/MinSizeRel']:
+    abs_candidate_dir = os.path.abspath(candidate_dir)
+    if os.path.isdir(abs_candidate_dir):
+        sys.path.insert(0, abs_candidate_dir)
+
+try:
+    import numpy as np
+    import ThetaStarPlanner
+except ImportError as e:
+    print(f"Error importing ThetaStarPlanner or numpy: {e}")
+    print("Please build the module first (see README.md) and make sure it is in your PYTHONPATH.")
+    exit(1)
+
+
+# Checks that a shared Planner gives every thread exactly the sequential results. Raises AssertionError on the
+# first mismatch and re-raises exceptions of the worker threads, so the script exits with a non-zero status.
+# Every run starts from a new Planner, so the lazily built tables (JPS+ tables, connected components, HPA*
+# graphs, subgoal graphs, ...) are built while the threads or the batch workers are already querying.
+
+def check(condition, message):
+    if not condition:
+        raise AssertionError(message)
+
+
+def make_map(size, seed):
+    rng = random.Random(seed)
+    grid = np.zeros((size, size), dtype=np.int8)
+    for _ in range(size * size // 400):
+        r, c = rng.randrange(size), rng.randrange(size)
+        grid[r:r + rng.randint(2, 13), c:c + rng.randint(2, 13)] = 1
+    return grid
+
+
+def make_queries(grid, count, seed):
+    rng = random.Random(seed)
+    free = np.argwhere(grid == 0)
+    starts, goals = [], []
+    for _ in range(count):
+        (sr, sc), (gr, gc) = free[rng.randrange(len(free))], free[rng.randrange(len(free))]
+        starts.append([sc + 0.5, sr + 0.5])
+        goals.append([gc + 0.5, gr + 0.5])
+    return np.array(starts), np.array(goals)
+
+
+def same_result(expected, actual):
+    (status1, path1, _), (status2, path2, _) = expected, actual
+    return status1 == status2 and np.array_equal(path1, path2)
+
+
+# Runs the queries on one shared Planner from several Python threads at once and compares them with a
+# sequential run on another Planner
+def check_threads(grid, starts, goals, searchtypes, num_threads):
+    size = grid.shape[0]
+    sequential_planner = ThetaStarPlanner.Planner([0.0, 0.0], [size, size], grid, 1.0)
+    queries = [(list(starts[k]), list(goals[k]), searchtypes[k % len(searchtypes)]) for k in range(len(starts))]
+
+    begin = time.perf_counter()
+    expected = [sequential_planner.plan(start, goal, searchtype=st) for start, goal, st in queries]
+    sequential = time.perf_counter() - begin
+
+    planner = ThetaStarPlanner.Planner([0.0, 0.0], [size, size], grid, 1.0)
+    results = [None] * len(queries)
+    errors = []
+
+    def worker(first):
+        try:
+            for k in range(first, len(queries), num_threads):
+                start, goal, st = queries[k]
+                results[k] = planner.plan(start, goal, searchtype=st)
+        except Exception as error:
+            errors.append(error)
+
+    threads = [threading.Thread(target=worker, args=(t,)) for t in range(num_threads)]
+    begin = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    concurrent = time.perf_counter() - begin
+
+    if errors:
+        raise errors[0]
+    for k in range(len(queries)):
+        check(results[k] is not None, f"query {k} ({queries[k][2]}) got no result")
+        check(same_result(expected[k], results[k]),
+              f"query {k} ({queries[k][2]}) differs between the sequential and the threaded run")
+    print(f"{len(queries)} queries, {num_threads} threads: sequential {sequential * 1000:.0f} ms, "
+          f"threads {concurrent * 1000:.0f} ms (speedup {sequential / concurrent:.2f}x)")
+
+
+# Plans the batch with plan_many on a new Planner and compares every answer with a sequential plan
+def check_plan_many(grid, starts, goals, searchtype, num_threads):
+    size = grid.shape[0]
+    sequential_planner = ThetaStarPlanner.Planner([0.0, 0.0], [size, size], grid, 1.0)
+    expected = [sequential_planner.plan(list(starts[k]), list(goals[k]), searchtype=searchtype)
+                for k in range(len(starts))]
+
+    planner = ThetaStarPlanner.Planner([0.0, 0.0], [size, size], grid, 1.0)
+    results = planner.plan_many(starts, goals, threads=num_threads, searchtype=searchtype)
+    check(len(results) == len(expected), f"plan_many ({searchtype}) returned {len(results)} of {len(expected)} results")
+    for k in range(len(expected)):
+        check(same_result(expected[k], results[k]), f"plan_many query {k} ({searchtype}) differs from plan")
+
+    # The module level plan_many makes its own Planner
+    results = ThetaStarPlanner.plan_many([0.0, 0.0], [size, size], grid, 1.0, starts, goals,
+                                         threads=num_threads, searchtype=searchtype)
+    for k in range(len(expected)):
+        check(same_result(expected[k], results[k]),
+              f"ThetaStarPlanner.plan_many query {k} ({searchtype}) differs from plan")
+    print(f"plan_many {searchtype}: {len(expected)} queries, {num_threads} threads match")
+
+
+def main(num_threads=8):
+    grid = make_map(512, 1)
+    starts, goals = make_queries(grid, 200, 2)
+    check_threads(grid, starts, goals, ["astar", "theta", "lazytheta", "jps", "jpsplus", "hpastar", "bastar"],
+                  num_threads)
+
+    # The tables of these searches are built on the first query of the batch
+    small = make_map(128, 3)
+    starts, goals = make_queries(small, 100, 4)
+    for searchtype in ["astar", "jpsplus", "hpastar", "cpd", "ch", "hl", "subgoal"]:
+        check_plan_many(small, starts, goals, searchtype, num_threads)
+    print("All threaded results match the sequential ones")
+
+
+if __name__ == "__main__":
+    main(num_threads=int(sys.argv[1]) if len(sys.argv) > 1 else 8)
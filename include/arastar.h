@@ -0,0 +1,58 @@
+#ifndef ARASTAR_H
+#define ARASTAR_H
+#include "astar.h"
+#include <chrono>
+
+#define CN_ARA_WEIGHT   3   //first weight when hweight is 1
+#define CN_ARA_STEP     0.5 //the weight is lowered by this much after every path
+
+#define CN_ARA_CLOSED   0x80000000u
+#define CN_ARA_INCONS   0x40000000u
+#define CN_ARA_ITER     0x3FFFFFFFu
+
+//ARA* (anytime repairing A*, Likhachev et al.): a weighted A* that finds a first path quickly and keeps improving
+//it with smaller weights until the path is optimal or the deadline has passed. Every new search keeps the g-values
+//of the previous one and only reopens the cells whose g-value dropped after they were closed (INCONS), so lowering
+//the weight costs much less than a search from scratch. sresult.suboptimality bounds the length of the returned path
+//divided by the optimal one. The first path is always searched to the end, the deadline only stops the improvements.
+//The bound needs a consistent heuristic: use the octile (diagonal) metric with diagonal moves, Manhattan without.
+//The limits of setLimits count the expansions of all iterations. Once a path is found they stop the improvements
+//like the deadline, before that the path to the closed cell closest to the goal is returned as partial.
+class ARAStar : public Astar
+{
+    public:
+        //hweight is the first weight (CN_ARA_WEIGHT if it is 1), deadline in milliseconds (0 = until the path is optimal)
+        ARAStar(double HW, bool BT, double deadline);
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+
+    private:
+        //12 bytes per cell like CellState: 'stamp' packs the last iteration that wrote the record (low 30 bits)
+        //with whether that iteration closed the cell or put it in INCONS. Iterations are numbered across searches,
+        //so records older than the first iteration of the current search read as unvisited
+        struct State
+        {
+            float           g;
+            int             parent;
+            unsigned int    stamp;
+        };
+        typedef std::chrono::steady_clock Clock;
+
+        double gValue(int id) const;
+        //Expands cells until no cell in OPEN has a smaller F than the goal, false if the deadline or the limits
+        //stopped it first
+        bool improvePath(const Map &map, const EnvironmentOptions &options, double weight, bool timed, Clock::time_point stop,
+                         std::chrono::time_point<std::chrono::system_clock> start);
+        double lowestF(const Map &map, const EnvironmentOptions &options);//Smallest g + h in OPEN and INCONS
+        void reorderOpen(const Map &map, const EnvironmentOptions &options, double weight);//Moves INCONS to OPEN, ordered for 'weight'
+
+        std::vector<State>  state;
+        std::vector<int>    incons;
+        std::vector<Node>   buffer;
+        int                 width, goal;
+        Node                closest;//closed cell with the smallest H
+        unsigned int        first, iteration;//first iteration of the current search and the current one
+        unsigned int        expansions;
+        double              deadline;
+};
+
+#endif // ARASTAR_H
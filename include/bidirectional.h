@@ -0,0 +1,66 @@
+#ifndef BIDIRECTIONAL_H
+#define BIDIRECTIONAL_H
+#include "astar.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+
+#define CN_BD_CLOSED 0x80000000u //set in the generation of a published g once the cell is closed
+
+//Bidirectional A* (or Dijkstra: no heuristic) with front-to-end heuristics. The forward direction searches from
+//the start towards the goal, the backward one from the goal towards the start, and every cell reached by both
+//gives a path through it. The best of these paths is optimal as soon as the smallest F of either OPEN list
+//is not below its length (for Dijkstra also when the two smallest g-values add up to it).
+//With 'parallel' the two directions run at the same time on two threads; they only share the cells each
+//direction has reached (with their g-values) and the best path length, all through atomics.
+//A search stopped by setLimits returns the best path found so far or else the path to the cell closed by the
+//forward direction that is closest to the goal, as partial. On two threads each direction takes half of the expansions.
+class BidirectionalAstar : public Astar
+{
+    public:
+        BidirectionalAstar(double HW, bool BT, bool dijkstra, bool parallel);
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+
+    protected:
+        double computeHFromCellToCell(int i1, int j1, int i2, int j2, const EnvironmentOptions &options);
+
+    private:
+        struct Frontier
+        {
+            CellStateTable          cells;
+            OpenList                open;
+            int                     target_i, target_j;
+            unsigned int            expansions;
+            std::atomic<double>     minF;//F at the top of OPEN, read by the other direction
+            //g of the reached cells for the other thread: (generation | CN_BD_CLOSED if closed) << 32 | bits of the float g
+            std::unique_ptr<std::atomic<uint64_t>[]>    reached;
+            std::size_t                                 reachedSize;
+            uint32_t                                    generation;
+        };
+
+        //Resets the direction and returns its root node (i, j), which it does not add to OPEN yet
+        Node startFrontier(int side, int i, int j, int target_i, int target_j, const Map &map, const EnvironmentOptions &options);
+        template <bool Parallel>
+        bool expand(int side, const Map &map, const EnvironmentOptions &options);//Returns false once the search can stop
+        template <bool Parallel>
+        void setOpen(int side, const Node &node, int id);//Records the node and checks whether the other direction reached it
+        void meet(double length, int id);
+        void updateMinF(Frontier &self);
+        void runParallel(int side, const Map &map, const EnvironmentOptions &options,
+                         std::chrono::time_point<std::chrono::system_clock> start);
+        void makePath(int last);//From the start to the cell 'last' and on to the goal if it is the meeting cell
+
+        Frontier            frontiers[2];//forward, backward
+        bool                dijkstra, parallel;
+        std::atomic<double> best;//length of the best path found so far
+        std::atomic<bool>   finished;//set by the first direction that stops
+        std::atomic<bool>   stopped;//set if a direction reached the limits
+        std::mutex          meetMutex;//keeps 'best' and 'meeting' consistent
+        int                 meeting;//cell where the two halves of the best path meet, -1 if none
+        Node                closest;//cell closed by the forward direction with the smallest distance to the goal
+        double              closestH;
+};
+
+#endif // BIDIRECTIONAL_H
@@ -0,0 +1,84 @@
+#ifndef BITGRID_H
+#define BITGRID_H
+
+#include "gl_const.h"
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <stdint.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//Index of the lowest/highest set bit of a non-zero word
+inline int lowestBit(uint64_t word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+inline int highestBit(uint64_t word)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, word);
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(word);
+#endif
+}
+
+//Occupancy grid packed to one bit per cell (1 = obstacle). The grid is surrounded by a
+//one-cell obstacle border and every row is padded with obstacles to a multiple of 64 bits,
+//so rows -1..height and columns -1..width can be read without bounds checks.
+//Column j of a row is stored in bit (j + 1) % 64 of word (j + 1) / 64.
+class BitGrid
+{
+    public:
+        BitGrid();
+
+        void assign(int height, int width);//Free grid of the given size surrounded by the border
+        void transpose(BitGrid &result) const;//Column-major copy, rows of the result are columns of this grid
+        void setObstacle(int i, int j, bool obstacle);
+        template <class T>
+        void fillRow(int i, const T *cells);//Marks cells of a free row whose value is not CN_GC_NOOBS as obstacles
+        bool isObstacle(int i, int j) const
+        {
+            int pos = j + 1;
+            return (bits[static_cast<std::size_t>(i + 1) * stride + (pos >> 6)] >> (pos & 63)) & 1;
+        }
+        const uint64_t* row(int i) const {return &bits[static_cast<std::size_t>(i + 1) * stride];}
+        std::size_t memoryUsage() const {return bits.size() * sizeof(uint64_t);}
+        uint64_t fingerprint() const;//FNV-1a hash of the size and the occupancy, saved with preprocessing to recognise its map
+        bool operator==(const BitGrid &other) const
+        {
+            return height == other.height && width == other.width && bits == other.bits;
+        }
+
+        int height, width;
+        int stride;//number of 64-bit words per row
+
+    private:
+        std::vector<uint64_t> bits;
+};
+
+template <class T>
+void BitGrid::fillRow(int i, const T *cells)
+{
+    uint64_t *words = &bits[static_cast<std::size_t>(i + 1) * stride];
+    //Word w holds columns w * 64 - 1 .. w * 64 + 62
+    for (int w = 0; w < stride; w++) {
+        int first = std::max(w * 64 - 1, 0), last = std::min(w * 64 + 63, width);
+        uint64_t word = 0;
+        for (int j = first; j < last; j++)
+            word |= static_cast<uint64_t>(cells[j] != CN_GC_NOOBS) << (j + 1 - w * 64);
+        words[w] |= word;
+    }
+}
+
+#endif // BITGRID_H
@@ -0,0 +1,136 @@
+#ifndef BUCKETQUEUE_H
+#define BUCKETQUEUE_H
+
+#include "bitgrid.h"
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+//Monotone priority queue of cell ids with 64-bit integer keys (Dial's buckets, one per key value, reused cyclically).
+//All keys in the queue must lie in [k, k + window) where k is the smallest of them; A* with integer move costs
+//and a consistent heuristic keeps this as long as window > 2 * (largest move cost).
+//A bit per bucket marks the non-empty ones and a second level of bits marks the non-empty 64-bucket words,
+//so finding the next key scans at most a few words: push and pop are amortized O(1) in the number of keys.
+//Entries with equal keys are ordered by g (largest first if GMax), as the tie-breaking of the heap-based OPEN.
+//A cell may be pushed again with a better g, the caller skips the outdated entries it pops.
+template <bool GMax>
+class BucketQueue
+{
+    public:
+        struct Entry
+        {
+            uint64_t        key, g;
+            int             id;
+        };
+
+        BucketQueue() : mask(0), minKey(0), count(0) {}
+
+        void reset(unsigned int window);//Empties the queue, 'window' is rounded up to a power of two (at least 64)
+        void push(uint64_t key, uint64_t g, int id);
+        Entry pop();//Removes the entry with the smallest key, the queue must not be empty
+        bool empty() const {return count == 0;}
+        std::size_t size() const {return count;}
+
+    private:
+        struct Item
+        {
+            uint64_t        g;
+            int             id;
+        };
+
+        static bool before(const Item &a, const Item &b) {return GMax ? a.g < b.g : a.g > b.g;}//heap order inside a bucket
+        unsigned int firstUsed() const;//Position of the first non-empty bucket at or after minKey (cyclically)
+        std::size_t nextUsedWord(std::size_t begin, std::size_t end) const;//First non-empty word in [begin, end) or end
+
+        std::vector<std::vector<Item>>  buckets;
+        std::vector<uint64_t>           used;//bit p % 64 of word p / 64 is set if bucket p is not empty
+        std::vector<uint64_t>           summary;//bit w % 64 of word w / 64 is set if used[w] != 0
+        unsigned int                    mask;//number of buckets - 1
+        uint64_t                        minKey;//no key in the queue is smaller
+        std::size_t                     count;
+};
+
+template <bool GMax>
+void BucketQueue<GMax>::reset(unsigned int window)
+{
+    unsigned int size = 64;
+    while (size < window)
+        size *= 2;
+    if (buckets.size() != size) {
+        buckets.assign(size, std::vector<Item>());
+        used.assign(size / 64, 0);
+        summary.assign((size / 64 + 63) / 64, 0);
+    }
+    else if (count > 0) {
+        //Only the buckets still holding entries need to be cleared
+        for (std::size_t w = 0; w < used.size(); w++)
+            for (uint64_t bits = used[w]; bits; bits &= bits - 1)
+                buckets[w * 64 + lowestBit(bits)].clear();
+        std::fill(used.begin(), used.end(), 0);
+        std::fill(summary.begin(), summary.end(), 0);
+    }
+    mask = size - 1;
+    minKey = 0;
+    count = 0;
+}
+
+template <bool GMax>
+void BucketQueue<GMax>::push(uint64_t key, uint64_t g, int id)
+{
+    if (count == 0 || key < minKey)
+        minKey = key;
+    unsigned int pos = static_cast<unsigned int>(key & mask);
+    std::vector<Item> &bucket = buckets[pos];
+    Item item = {g, id};
+    bucket.push_back(item);
+    std::push_heap(bucket.begin(), bucket.end(), before);
+    used[pos / 64] |= uint64_t(1) << (pos % 64);
+    summary[pos / 4096] |= uint64_t(1) << (pos / 64 % 64);
+    count++;
+}
+
+template <bool GMax>
+unsigned int BucketQueue<GMax>::firstUsed() const
+{
+    unsigned int from = static_cast<unsigned int>(minKey & mask);
+    std::size_t word = from / 64;
+    uint64_t bits = used[word] & (~uint64_t(0) << (from % 64));
+    if (bits)
+        return static_cast<unsigned int>(word * 64 + lowestBit(bits));
+    //Next non-empty word after 'word', then wrap around to the lower buckets (the high ones of 'word' are empty)
+    std::size_t next = nextUsedWord(word + 1, used.size());
+    if (next == used.size())
+        next = nextUsedWord(0, word + 1);
+    return static_cast<unsigned int>(next * 64 + lowestBit(used[next]));
+}
+
+template <bool GMax>
+std::size_t BucketQueue<GMax>::nextUsedWord(std::size_t begin, std::size_t end) const
+{
+    for (std::size_t w = begin; w < end; w = (w / 64 + 1) * 64) {
+        uint64_t marks = summary[w / 64] & (~uint64_t(0) << (w % 64));
+        if (marks)
+            return std::min(w / 64 * 64 + lowestBit(marks), end);
+    }
+    return end;
+}
+
+template <bool GMax>
+typename BucketQueue<GMax>::Entry BucketQueue<GMax>::pop()
+{
+    unsigned int pos = firstUsed();
+    minKey += (pos - minKey) & mask;
+    std::vector<Item> &bucket = buckets[pos];
+    std::pop_heap(bucket.begin(), bucket.end(), before);
+    Entry entry = {minKey, bucket.back().g, bucket.back().id};
+    bucket.pop_back();
+    if (bucket.empty()) {
+        used[pos / 64] &= ~(uint64_t(1) << (pos % 64));
+        if (!used[pos / 64])
+            summary[pos / 4096] &= ~(uint64_t(1) << (pos / 64 % 64));
+    }
+    count--;
+    return entry;
+}
+
+#endif // BUCKETQUEUE_H
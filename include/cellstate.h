@@ -0,0 +1,45 @@
+#ifndef CELLSTATE_H
+#define CELLSTATE_H
+
+#include "node.h"
+#include <vector>
+
+#define CN_CS_OPEN      0x40000000u
+#define CN_CS_CLOSED    0x80000000u
+#define CN_CS_GEN_MASK  0x3FFFFFFFu
+
+//Search record of a single grid cell (12 bytes). 'stamp' packs the generation of the search
+//that wrote the record (low 30 bits) together with the OPEN/CLOSED flags (high 2 bits), so
+//records left by previous searches read as unvisited without clearing the array.
+struct CellState
+{
+    float           g;
+    int             parent; //index of the parent cell (i * width + j), -1 for the start cell
+    unsigned int    stamp;
+};
+
+//Dense per-cell state of a search, indexed by i * width + j
+class CellStateTable
+{
+    public:
+        CellStateTable();
+
+        void reset(int height, int width);//Starts a new generation, reallocates only when the grid size changes
+
+        int index(int i, int j) const {return i * width + j;}
+        bool isOpen(int id) const {return cells[id].stamp == (generation | CN_CS_OPEN);}
+        bool isClosed(int id) const {return cells[id].stamp == (generation | CN_CS_CLOSED);}
+        bool isVisited(int id) const {return (cells[id].stamp & CN_CS_GEN_MASK) == generation;}
+        void setOpen(int id, double g, int parent);
+        void setClosed(int id) {cells[id].stamp = generation | CN_CS_CLOSED;}
+        const CellState& operator[](int id) const {return cells[id];}
+        Node node(int id) const;//Restores the Node (i, j, g, parent) stored in the cell
+
+        int height, width;
+
+    private:
+        std::vector<CellState>  cells;
+        unsigned int            generation;
+};
+
+#endif // CELLSTATE_H
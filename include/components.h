@@ -0,0 +1,38 @@
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+#include "map.h"
+#include "environmentoptions.h"
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+//Connected components of the free cells of a map for one set of movement rules. Two cells have the same label
+//if and only if there is a path between them. Every allowed diagonal move, except for squeezing, passes a free
+//cell next to both of its ends, so all rules but CN_MR_SQUEEZE connect the same cells as straight moves alone
+//and share one labelling (built with diagonal = false).
+class ComponentLabels
+{
+    public:
+        ComponentLabels();
+
+        static bool diagonalFor(int movement) {return movement == CN_MR_SQUEEZE;}
+        static std::shared_ptr<const ComponentLabels> build(const Map &map, int movement);
+        bool fits(const Map &map, const EnvironmentOptions &options) const;
+        std::size_t memoryUsage() const;
+        //Component of the cell, -1 for obstacles
+        int label(int i, int j) const {return labels[static_cast<std::size_t>(i) * width + j];}
+        bool connected(int i1, int j1, int i2, int j2) const
+        {
+            int label1 = label(i1, j1);
+            return label1 >= 0 && label1 == label(i2, j2);
+        }
+
+        int                             height, width;
+        bool                            diagonal;   //whether squeezing diagonal moves connect cells
+        int                             count;      //number of components
+        double                          buildTime;  //seconds
+        std::shared_ptr<const BitGrid>  grid;       //occupancy the labels were built from (shared with the map)
+        std::vector<int32_t>            labels;
+};
+
+#endif // COMPONENTS_H
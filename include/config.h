@@ -12,7 +12,10 @@ class Config
         bool getConfig(const char *FileName);
 
         // Set all search parameters directly (see gl_const.h for details)
-        // st: search type (CN_SP_ST_ASTAR or CN_SP_ST_TH)
+        // st: search type (CN_SP_ST_ASTAR, CN_SP_ST_TH, CN_SP_ST_JPS, CN_SP_ST_JPSPLUS, CN_SP_ST_BASTAR,
+        //     CN_SP_ST_BDIJKSTRA, CN_SP_ST_HPASTAR, CN_SP_ST_HPATHETA, CN_SP_ST_LTH,
+        //     CN_SP_ST_DSL, CN_SP_ST_ARA, CN_SP_ST_CPD, CN_SP_ST_CH, CN_SP_ST_HL
+        //     or CN_SP_ST_SUB)
         // hw: heuristic weight (>=1)
         // mt: metric type (CN_SP_MT_DIAG, CN_SP_MT_MANH, CN_SP_MT_EUCL, CN_SP_MT_CHEB)
         // bt: breaking ties (CN_SP_BT_GMIN or CN_SP_BT_GMAX)
@@ -20,6 +23,9 @@ class Config
         // cc: cut corners (0 or 1)
         // asq: allow squeeze (0 or 1)
         // ps: post smoothing (0 or 1)
+        // The fixed-point (CN_SP_FP) and parallel (CN_SP_PAR) modes are turned off and there is no deadline (CN_SP_DL)
+        // and no expansion or time limit (CN_SP_EL, CN_SP_TL) or landmarks (CN_SP_LM), and paths are built
+        // (CN_SP_DO is off) without goal bounding (CN_SP_GB), set them with setParamByTag
         void setConfig(int st, double hw, int mt, int bt, int ad, int cc, int asq, int ps);
 
         // Set parameters by tag name (as in gl_const.h) and value (string or double)
@@ -32,6 +38,9 @@ class Config
         void setDefaultConfigTheta();
 
 
+    private:
+        void allocateParams();
+
     public:
         double*         SearchParams;
         unsigned int    N;
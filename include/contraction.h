@@ -0,0 +1,75 @@
+#ifndef CONTRACTION_H
+#define CONTRACTION_H
+#include "astar.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define CN_CH_VERSION   1   //format of the files written by ContractionHierarchy::save
+#define CN_CH_SETTLED   500 //witness searches give up (and keep the shortcut) after settling this many nodes
+
+//Contraction hierarchy (CH) of the free cells of one map for one set of movement rules. A contracted cell leaves the
+//graph, and where it was the only shortest path between two of its neighbours a shortcut joins them, so a query only
+//searches upwards from both ends. Cells that come before all their neighbours are contracted together, in parallel.
+class ContractionHierarchy
+{
+    public:
+        struct Arc
+        {
+            int32_t head;   //node the arc leads to, contracted after the tail
+            int32_t middle; //node the shortcut skips, -1 for a move between neighbouring cells
+            double  cost;
+        };
+
+        ContractionHierarchy();
+
+        //The node ordering runs on 'threads' workers (0 = one per hardware thread)
+        static std::shared_ptr<const ContractionHierarchy> build(const Map &map, const EnvironmentOptions &options,
+                                                                 int threads = 0);
+        //Reads a hierarchy written by save(). nullptr if the file cannot be read or was built for another grid
+        static std::shared_ptr<const ContractionHierarchy> load(const std::string &fileName, const Map &map);
+        bool save(const std::string &fileName) const;//Native byte order, false if the file cannot be written
+        bool fits(const Map &map, const EnvironmentOptions &options) const;
+        std::size_t memoryUsage() const;
+        int nodes() const {return static_cast<int>(cells.size());}
+        //Appends the nodes after 'from' on the path an arc between 'from' and 'to' stands for, up to 'to'.
+        //False if an arc the shortcut skips is missing, which only happens with a damaged file
+        bool unpack(int from, int to, int middle, std::vector<int> &path) const;
+
+        int                             height, width;
+        int                             movement;   //CN_MR_* rules the hierarchy was built for
+        double                          buildTime;  //seconds
+        std::shared_ptr<const BitGrid>  grid;       //occupancy the hierarchy was built from (shared with the map)
+        std::vector<int32_t>            node;       //node of every cell, -1 for obstacles
+        std::vector<int32_t>            cells;      //cell (i * width + j) of every node
+        std::vector<uint32_t>           first;      //upward arcs of node v are arcs[first[v]] .. arcs[first[v + 1] - 1]
+        std::vector<Arc>                arcs;       //sorted by head for every node
+
+    private:
+        void numberCells();//Fills node and cells from the grid
+        const Arc* findArc(int from, int to) const;//Upward arc from 'from' to 'to', nullptr if there is none
+};
+
+//Bidirectional Dijkstra search on the upward arcs of a ContractionHierarchy, with the path unpacked into moves.
+//Like the JPS+ table, the hierarchy is built on the first search (or given) and reused while it fits the map.
+//Paths are shortest octile paths like those of A*; the metric, the heuristic weight and the limits are not used.
+class CHSearch : public Astar
+{
+    public:
+        CHSearch(std::shared_ptr<const ContractionHierarchy> hierarchy = nullptr);
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+        std::shared_ptr<const ContractionHierarchy> getContractionHierarchy() const {return hierarchy;}
+
+    private:
+        typedef std::pair<double, int> Entry;//distance, node
+
+        std::shared_ptr<const ContractionHierarchy> hierarchy;
+        //Per direction: distances, arc (index into hierarchy->arcs) each node was reached by, nodes to reset
+        std::vector<double>     dist[2];
+        std::vector<int>        parentArc[2], parent[2];
+        std::vector<int>        touched;
+        std::vector<Entry>      queue[2];//binary heaps
+};
+
+#endif // CONTRACTION_H
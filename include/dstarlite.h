@@ -0,0 +1,68 @@
+#ifndef DSTARLITE_H
+#define DSTARLITE_H
+#include "astar.h"
+#include <vector>
+#include <utility>
+
+//D* Lite (Koenig and Likhachev) on a copy of the map that can change between searches. It searches from the goal
+//towards the start and keeps the g- and rhs-values of the cells between calls of replan(), so after the start
+//moves or a few cells change only the part of the search those changes affect is repaired.
+//The heuristic is octile (Manhattan without diagonal moves) whatever the metric, it has to be consistent.
+//As an ISearch, startSearch() reuses the state while the goal, the grid size and the movement rules stay the same:
+//it compares the grid with its copy, reports the cells that differ and moves the start.
+class DStarLite : public Astar
+{
+    public:
+        DStarLite();
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+
+        //Starts over on the grid, start and goal of the map. The grid is copied, later changes go through setCell
+        void reset(const Map &map, const EnvironmentOptions &options);
+        bool isReady() const {return height > 0;}
+        bool setStart(int i, int j);//False if the cell is outside the grid
+        bool setGoal(int i, int j);//Starts over on the current grid, false if the cell is outside the grid
+        void setCell(int i, int j, bool obstacle);//Reports a changed cell, does nothing if it is unchanged
+        void updateGrid(const BitGrid &other);//Reports the cells where other differs from the copy (same size)
+        bool isObstacle(int i, int j) const {return grid.isObstacle(i, j);}
+        //Repairs the search and returns the path from the current start to the goal
+        SearchResult replan();
+
+    private:
+        typedef std::pair<double, double> Key;
+        struct Cell
+        {
+            double  g, rhs;
+            Key     key;//key of the cell in OPEN
+            bool    queued;
+        };
+        struct Entry
+        {
+            Key     key;
+            int     id;
+            bool operator<(const Entry &other) const {return other.key < key;}//smallest key on top of the heap
+        };
+
+        void restart();//Drops the search, keeps the grid
+        double heuristic(int id) const;//From the start
+        //Calls visit(neighbour, cost) for every allowed move from cell id (the moves are symmetric,
+        //so these are also its predecessors)
+        template <class Visit>
+        void forNeighbours(int id, Visit visit) const;
+        Key calculateKey(int id) const;
+        void updateVertex(int id);
+        double bestSuccessor(int id, int &next) const;//min of cost + g over the neighbours
+        void computeShortestPath();
+        void compactQueue();//Drops the outdated entries once they outnumber the queued cells
+
+        BitGrid                     grid;
+        int                         height, width;
+        int                         movement;
+        int                         start, goal, last;//'last' is the start when km was last updated
+        double                      km;
+        std::vector<Cell>           state;
+        std::vector<Entry>          queue;//binary heap, may hold outdated entries that are skipped when popped
+        std::size_t                 queued;//cells in OPEN
+        unsigned int                expansions;
+};
+
+#endif // DSTARLITE_H
@@ -7,6 +7,7 @@ class EnvironmentOptions
 public:
     EnvironmentOptions(bool AS, bool AD, bool CC, int MT = CN_SP_MT_EUCL);
     EnvironmentOptions();
+    int movementRules() const; //One of CN_MR_* constants
     int     metrictype;     //Can be chosen Euclidean, Manhattan, Chebyshev and Diagonal distance
     bool    allowsqueeze;   //Option that allows to move throught "bottleneck"
     bool    allowdiagonal;  //Option that allows to make diagonal moves
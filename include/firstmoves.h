@@ -0,0 +1,28 @@
+#ifndef FIRSTMOVES_H
+#define FIRSTMOVES_H
+#include "map.h"
+#include <vector>
+#include <stdint.h>
+
+//All-pairs preprocessing of the free cells (the compressed path database, the goal bounds) runs one Dijkstra
+//search per cell that records the first moves of the optimal paths. Moves are numbered as in CPDSearch::moves.
+
+//Per-worker buffers of firstMoves
+struct FirstMoveBuffers
+{
+    std::vector<double>     dist;
+    std::vector<uint8_t>    mask, closed;
+    std::vector<int>        buckets[3];
+};
+
+//Allowed moves between the free cells 'cells' (i * width + j) under the CN_MR_* rules 'movement', as lists of
+//(index of the neighbour << 3 | move), where index gives the position of every cell in 'cells'. The moves of
+//cells[r] are edges[first[r]] .. edges[first[r + 1] - 1]
+void linkCells(const Map &map, int movement, const std::vector<int> &cells, const std::vector<int32_t> &index,
+               std::vector<int> &first, std::vector<uint32_t> &edges);
+
+//Dijkstra search from cells[source] that leaves in buffers.mask[r] the set of first moves (bit k for move k)
+//of all optimal paths to cells[r], 0 for the source and the cells it cannot reach
+void firstMoves(const std::vector<int> &first, const std::vector<uint32_t> &edges, int source, FirstMoveBuffers &buffers);
+
+#endif // FIRSTMOVES_H
@@ -0,0 +1,27 @@
+#ifndef FIXEDPOINTASTAR_H
+#define FIXEDPOINTASTAR_H
+#include "astar.h"
+#include "bucketqueue.h"
+#include <vector>
+
+//A* on integer move costs (CN_FP_STRAIGHT and CN_FP_DIAGONAL) with a BucketQueue as OPEN.
+//The heuristic is the octile distance under the same costs (Manhattan without diagonal moves): it is
+//consistent in integers, so F never decreases along the search and every key fits the bucket window.
+//The metric type and the heuristic weight are therefore not used. Path lengths are reported in cells
+//as usual, measured on the path that was found.
+template <int Movement, bool GMax>
+class FixedPointAstar : public Astar
+{
+    public:
+        FixedPointAstar():Astar(1, GMax){}
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+
+    private:
+        std::vector<uint64_t>       g;//fixed-point g of every cell visited by the current search (long paths pass 2^32)
+        BucketQueue<GMax>           queue;
+};
+
+//Returns the fixed-point A* for the movement rules (CN_MR_*) or nullptr if they are unknown
+ISearch* createFixedPointSearch(int movement, bool breakingties);
+
+#endif // FIXEDPOINTASTAR_H
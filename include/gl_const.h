@@ -16,15 +16,49 @@
         #define CNS_TAG_AD          "allowdiagonal"
         #define CNS_TAG_CC          "cutcorners"
         #define CNS_TAG_PS          "postsmoothing"
+        #define CNS_TAG_FP          "fixedpoint"
+        #define CNS_TAG_PAR         "parallel"
+        #define CNS_TAG_DL          "deadline"
+        #define CNS_TAG_EL          "maxexpansions"
+        #define CNS_TAG_TL          "maxtime"
+        #define CNS_TAG_LM          "landmarks"
+        #define CNS_TAG_DO          "distanceonly"
+        #define CNS_TAG_GB          "goalbounding"
 
 
 //Search Parameters
     #define CN_SP_ST 0
         #define CNS_SP_ST_ASTAR         "astar"
         #define CNS_SP_ST_TH            "theta"
+        #define CNS_SP_ST_JPS           "jps"
+        #define CNS_SP_ST_JPSPLUS       "jpsplus"
+        #define CNS_SP_ST_BASTAR        "bastar"
+        #define CNS_SP_ST_BDIJKSTRA     "bdijkstra"
+        #define CNS_SP_ST_HPASTAR       "hpastar"
+        #define CNS_SP_ST_HPATHETA      "hpatheta"
+        #define CNS_SP_ST_LTH           "lazytheta"
+        #define CNS_SP_ST_DSL           "dstarlite"
+        #define CNS_SP_ST_ARA           "arastar"
+        #define CNS_SP_ST_CPD           "cpd"
+        #define CNS_SP_ST_CH            "ch"
+        #define CNS_SP_ST_HL            "hl"
+        #define CNS_SP_ST_SUB           "subgoal"
 
         #define CN_SP_ST_ASTAR          2
+        #define CN_SP_ST_JPS            3
         #define CN_SP_ST_TH             4
+        #define CN_SP_ST_JPSPLUS        5
+        #define CN_SP_ST_BASTAR         6 //Bidirectional A*
+        #define CN_SP_ST_BDIJKSTRA      7 //Bidirectional Dijkstra
+        #define CN_SP_ST_HPASTAR        8 //HPA* refined by A*
+        #define CN_SP_ST_HPATHETA       9 //HPA* refined by Theta*
+        #define CN_SP_ST_LTH            10 //Lazy Theta*
+        #define CN_SP_ST_DSL            11 //D* Lite
+        #define CN_SP_ST_ARA            12 //ARA* (anytime repairing A*)
+        #define CN_SP_ST_CPD            13 //Compressed path database
+        #define CN_SP_ST_CH             14 //Contraction hierarchy
+        #define CN_SP_ST_HL             15 //Hub labels
+        #define CN_SP_ST_SUB            16 //Subgoal graph
 
     #define CN_SP_AD 1 //AllowDiagonal
 
@@ -56,7 +90,35 @@
 
     #define CN_SP_PS 7 //PostSmoothing
 
+    #define CN_SP_FP 8 //FixedPoint: A* on integer move costs with a bucket OPEN list
 
+        #define CN_FP_STRAIGHT  1000 //cost of a straight move in fixed point
+        #define CN_FP_DIAGONAL  1414 //sqrt(2) * CN_FP_STRAIGHT, rounded
+
+    #define CN_SP_PAR 9 //Parallel: the two directions of a bidirectional search run on two threads
+
+    #define CN_SP_DL 10 //Deadline of ARA* in milliseconds, 0 = improve the path until it is optimal
+
+    #define CN_SP_EL 11 //ExpansionLimit: the search stops with a partial path after this many expansions, 0 = no limit
+
+    #define CN_SP_TL 12 //TimeLimit: same after this many milliseconds, 0 = no limit
+
+    #define CN_SP_LM 13 //Landmarks: A* adds the ALT heuristic of this many landmarks (at most CN_LM_MAX), 0 = off
+
+        #define CN_LM_MAX       64 //most landmarks a table can have
+
+    #define CN_SP_DO 14 //DistanceOnly: searches report the path length without building the path
+
+    #define CN_SP_GB 15 //GoalBounding: A*, JPS and JPS+ skip moves whose goal bounds do not contain the goal
+
+
+
+//Movement rules implied by allowdiagonal, cutcorners and allowsqueeze
+    #define CN_MR_CARDINAL  0 //Only straight moves
+    #define CN_MR_NOCORNER  1 //Diagonal moves need both adjacent cells to be free
+    #define CN_MR_CORNER    2 //Diagonal moves need at least one adjacent cell to be free
+    #define CN_MR_SQUEEZE   3 //Diagonal moves only need the target cell to be free
+    #define CN_MR_COUNT     4
 
 //Grid Cell
     #define CN_GC_NOOBS 0
@@ -0,0 +1,67 @@
+#ifndef GOALBOUNDS_H
+#define GOALBOUNDS_H
+#include "astar.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define CN_GB_VERSION 1 //format of the files written by GoalBounds::save
+
+//Goal bounds of one map for one set of movement rules: for every free cell and move out of it, the bounding box of
+//the cells an optimal path starting with that move leads to. A cell takes 64 bytes.
+class GoalBounds
+{
+    public:
+        struct Box
+        {
+            uint16_t    min_i, max_i, min_j, max_j;//min > max for a move that leads nowhere
+        };
+
+        GoalBounds();
+
+        //The sources are searched on 'threads' workers (0 = one per hardware thread)
+        static std::shared_ptr<const GoalBounds> build(const Map &map, const EnvironmentOptions &options, int threads = 0);
+        //Reads bounds written by save(). nullptr if the file cannot be read or was built for another grid
+        static std::shared_ptr<const GoalBounds> load(const std::string &fileName, const Map &map);
+        bool save(const std::string &fileName) const;//Native byte order, false if the file cannot be written
+        bool fits(const Map &map, const EnvironmentOptions &options) const;
+        std::size_t memoryUsage() const;
+        //Whether an optimal path from the free cell (i, j) to (goal_i, goal_j) can start with the move (di, dj)
+        bool allows(int i, int j, int di, int dj, int goal_i, int goal_j) const
+        {
+            //Moves in the order of CPDSearch::moves: (1, 1), (1, 0), (1, -1), (0, 1), (0, -1), (-1, 1), ...
+            int k = (1 - di) * 3 + (1 - dj);
+            const Box &box = boxes[static_cast<std::size_t>(node[static_cast<std::size_t>(i) * width + j]) * 8 + k - (k > 4)];
+            return goal_i >= box.min_i && goal_i <= box.max_i && goal_j >= box.min_j && goal_j <= box.max_j;
+        }
+
+        int                             height, width;
+        int                             movement;   //CN_MR_* rules the bounds were built for
+        double                          buildTime;  //seconds
+        std::shared_ptr<const BitGrid>  grid;       //occupancy the bounds were built from (shared with the map)
+        std::vector<int32_t>            node;       //index of every free cell (row by row), -1 for obstacles
+        std::vector<Box>                boxes;      //8 per free cell
+
+    private:
+        void numberCells(std::vector<int> &cells);//Fills node and returns the free cells (i * width + j)
+};
+
+//A* that skips the moves whose goal bounds do not contain the goal. Paths stay optimal, and on maps with
+//obstacles most of the moves off the optimal paths are never generated. The bounds are built on the first
+//search and reused while they fit, like the JPS+ table.
+class GoalBoundedAstar : public Astar
+{
+    public:
+        GoalBoundedAstar(double HW, bool BT, std::shared_ptr<const GoalBounds> bounds = nullptr);
+        std::shared_ptr<const GoalBounds> getGoalBounds() const {return bounds;}
+
+    protected:
+        void initSearch(const Map &map, const EnvironmentOptions &options);
+        int findSuccessors(const Node &curNode, const Map &map, const EnvironmentOptions &options, Node *successors);
+
+        std::shared_ptr<const GoalBounds>   bounds;
+        int                                 goal_i, goal_j;
+};
+
+#endif // GOALBOUNDS_H
@@ -0,0 +1,98 @@
+#ifndef HPASTAR_H
+#define HPASTAR_H
+#include "astar.h"
+#include <memory>
+
+#define CN_HPA_CLUSTER  32 //side of a cluster in cells
+#define CN_HPA_SPLIT    6  //entrances at least this wide get a transition at each end instead of one in the middle
+
+//Abstract graph of HPA* for one map and one set of movement rules. The map is cut into square clusters;
+//along the border of two neighbouring clusters every maximal run of cells that are free on both sides
+//is an entrance, crossed by one or two transitions (pairs of facing cells). The transition cells are the
+//nodes of the graph, its edges are the straight moves of the transitions and the shortest paths inside
+//a cluster between the nodes of that cluster.
+class ClusterGraph
+{
+    public:
+        struct Edge
+        {
+            int     to;
+            double  cost;
+        };
+
+        ClusterGraph();
+
+        //The clusters are connected in parallel on 'threads' workers (0 = one per hardware thread)
+        static std::shared_ptr<const ClusterGraph> build(const Map &map, const EnvironmentOptions &options, int threads = 0);
+        bool fits(const Map &map, const EnvironmentOptions &options) const;
+        std::size_t memoryUsage() const;
+        int cluster(int i, int j) const {return (i / CN_HPA_CLUSTER) * clustersWide + j / CN_HPA_CLUSTER;}
+        static int local(int i, int j) {return (i % CN_HPA_CLUSTER) * CN_HPA_CLUSTER + j % CN_HPA_CLUSTER;}
+        //Shortest distances from the free cell (i, j) to the cells of its cluster without leaving it,
+        //indexed by local(), -1 for the cells that cannot be reached
+        void clusterDistances(int i, int j, std::vector<double> &dist) const;
+
+        int                             height, width;
+        int                             clustersHigh, clustersWide;
+        int                             movement;   //CN_MR_* rules the graph was built for
+        double                          buildTime;  //seconds
+        std::shared_ptr<const BitGrid>  grid;       //occupancy the graph was built from (shared with the map)
+        std::vector<int>                cells;      //cell (i * width + j) of every node
+        std::vector<std::vector<Edge>>  edges;      //edges leaving every node
+        std::vector<std::vector<int>>   members;    //nodes of every cluster
+};
+
+//HPA*: finds a coarse path in the ClusterGraph and refines it segment by segment with A* (Theta* if anyAngle
+//is set) on the full map. Like the JPS+ table, the graph is built on the first search and reused by later ones.
+//Paths are close to optimal, not always optimal. The graph only crosses cluster borders with straight moves,
+//so when it has no path (e.g. the only way is a diagonal squeeze at a cluster corner) the refining search
+//gets the whole query.
+class HPAStar : public Astar
+{
+    public:
+        HPAStar(double HW, bool BT, bool anyAngle, std::shared_ptr<const ClusterGraph> graph = nullptr);
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+
+        //Coarse path from the start to the goal of the map as cells (i * width + j), false if the graph has none
+        bool findCoarsePath(const Map &map, const EnvironmentOptions &options, std::vector<int> &waypoints);
+        //Refines the coarse segment between two cells and appends it to the paths (without repeating their
+        //last cells). Returns the length of the segment or -1 if there is no path
+        double refine(const Map &map, const EnvironmentOptions &options, int from, int to,
+                      std::list<Node> &lowLevel, std::list<Node> &highLevel);
+        std::shared_ptr<const ClusterGraph> getClusterGraph() const {return graph;}
+
+    private:
+        const ClusterGraph& useGraph(const Map &map, const EnvironmentOptions &options);//Builds the graph if it does not fit
+        ISearch& refiner(const EnvironmentOptions &options);
+
+        std::shared_ptr<const ClusterGraph> graph;
+        std::unique_ptr<ISearch>            engine;//refining search, made for engineOptions
+        EnvironmentOptions                  engineOptions;
+        bool                                anyAngle;
+        std::vector<double>                 startDist, goalDist;
+};
+
+//Coarse HPA* path of one query whose segments are refined on demand, e.g. while the caller walks the first
+//ones. It keeps the grid and the graph it was made from alive, so it can outlive the search. Not thread-safe.
+class HierarchicalPath
+{
+    public:
+        HierarchicalPath(const Map &map, const EnvironmentOptions &options, double HW, bool BT, bool anyAngle,
+                         std::shared_ptr<const ClusterGraph> graph);
+
+        bool found() const {return !waypoints.empty();}
+        int segments() const {return waypoints.size() > 1 ? static_cast<int>(waypoints.size()) - 1 : 0;}
+        int waypointI(int k) const {return waypoints[k] / map.width;}
+        int waypointJ(int k) const {return waypoints[k] % map.width;}
+        //Cells of segment k (from waypoint k to waypoint k + 1, both included), false if it cannot be refined
+        bool refine(int k, std::list<Node> &path);
+        std::shared_ptr<const ClusterGraph> getClusterGraph() const {return search.getClusterGraph();}
+
+    private:
+        Map                 map;
+        EnvironmentOptions  options;
+        HPAStar             search;
+        std::vector<int>    waypoints;
+};
+
+#endif // HPASTAR_H
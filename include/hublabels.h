@@ -0,0 +1,82 @@
+#ifndef HUBLABELS_H
+#define HUBLABELS_H
+#include "contraction.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define CN_HL_VERSION   1   //format of the files written by HubLabels::save
+
+//Hub labels of the free cells of one map for one set of movement rules, made from a contraction hierarchy. Every
+//cell keeps its hubs sorted with its distances to them in three flat arrays, and load() maps the file into memory
+//where the system allows it, so only the labels queries touch are read.
+class HubLabels
+{
+    public:
+        HubLabels();
+        ~HubLabels();
+
+        //A hierarchy that fits the map is used (and not kept), otherwise one is built. The labels are made on
+        //'threads' workers (0 = one per hardware thread)
+        static std::shared_ptr<const HubLabels> build(const Map &map, const EnvironmentOptions &options, int threads = 0,
+                                                      std::shared_ptr<const ContractionHierarchy> hierarchy = nullptr);
+        //Reads (or maps) labels written by save(). nullptr if the file cannot be read or was built for another grid
+        static std::shared_ptr<const HubLabels> load(const std::string &fileName, const Map &map);
+        bool save(const std::string &fileName) const;//Native byte order, false if the file cannot be written
+        bool fits(const Map &map, const EnvironmentOptions &options) const;
+        std::size_t memoryUsage() const;
+        int nodes() const {return static_cast<int>(cells.size());}
+        //Length of a shortest path between the nodes, -1 if there is none
+        double distance(int v, int w) const;
+        //Same between the cells (i1, j1) and (i2, j2), -1 if there is none or one of them is not free
+        double distance(int i1, int j1, int i2, int j2) const
+        {
+            int v = node[static_cast<std::size_t>(i1) * width + j1], w = node[static_cast<std::size_t>(i2) * width + j2];
+            return (v < 0 || w < 0) ? -1 : distance(v, w);
+        }
+
+        int                             height, width;
+        int                             movement;   //CN_MR_* rules the labels were built for
+        double                          buildTime;  //seconds, with the hierarchy if it was built here
+        std::shared_ptr<const BitGrid>  grid;       //occupancy the labels were built from (shared with the map)
+        std::vector<int32_t>            node;       //node of every cell, -1 for obstacles
+        std::vector<int32_t>            cells;      //cell (i * width + j) of every node
+        //The label of node v is hubs[offsets[v]] .. hubs[offsets[v + 1] - 1] (ascending) and the same range of
+        //distances. They point into the vectors below or into the mapped file
+        const uint64_t                  *offsets;
+        const uint32_t                  *hubs;
+        const double                    *distances;
+        uint64_t                        entries;
+
+    private:
+        HubLabels(const HubLabels &);
+        HubLabels& operator=(const HubLabels &);
+
+        void numberCells();//Fills node and cells from the grid
+
+        std::vector<uint64_t>   offsetData;
+        std::vector<uint32_t>   hubData;
+        std::vector<double>     distanceData;
+        void                    *mapping;//file mapped by load(), nullptr otherwise
+        std::size_t             mappingSize;
+};
+
+//Answers queries from HubLabels. The path is followed move by move: from every cell it goes to a neighbour whose
+//distance to the goal is the distance left less the cost of the move, so it costs a few label merges per move.
+//With setDistanceOnly only the distance is looked up. Paths are shortest octile paths like those of A*.
+//The labels are built on the first search (from the hierarchy, if one is given) and reused while they fit the map.
+class HLSearch : public Astar
+{
+    public:
+        HLSearch(std::shared_ptr<const HubLabels> labels = nullptr,
+                 std::shared_ptr<const ContractionHierarchy> hierarchy = nullptr);
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+        std::shared_ptr<const HubLabels> getHubLabels() const {return labels;}
+
+    private:
+        std::shared_ptr<const HubLabels>            labels;
+        std::shared_ptr<const ContractionHierarchy> hierarchy;
+};
+
+#endif // HUBLABELS_H
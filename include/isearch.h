@@ -4,9 +4,13 @@
 #include "searchresult.h"
 #include "environmentoptions.h"
 #include <list>
-#include <unordered_map>
 #include <cmath>
 #include "map.h"
+#include "openlist.h"
+#include "cellstate.h"
+#include <chrono>
+
+#define CN_MAX_SUCCESSORS 8
 
 class ISearch
 {
@@ -14,25 +18,43 @@ class ISearch
         ISearch();
         virtual ~ISearch(void);
 
-        SearchResult startSearch(const Map &Map, const EnvironmentOptions &options);
+        virtual SearchResult startSearch(const Map &Map, const EnvironmentOptions &options);
+        //Later searches stop after maxExpansions expansions or maxTime milliseconds (0 = no limit) and return
+        //the path to the expanded node with the smallest H as partial. Bidirectional searches and ARA* check them
+        //in their own main loops, HPA* and D* Lite do not
+        void setLimits(unsigned int maxExpansions, double maxTime);
+        //Later searches only report the length (and the counters): lppath and hppath stay empty
+        void setDistanceOnly(bool distanceOnly) {distanceonly = distanceOnly;}
 
     protected:
         Node findMin();
+        virtual void initSearch(const Map &, const EnvironmentOptions &) {}//Called before the start node is added to OPEN
         virtual void addOpen(Node newNode);
         virtual double computeHFromCellToCell(int start_i, int start_j, int fin_i, int fin_j, const EnvironmentOptions &options) = 0;
-        virtual std::list<Node> findSuccessors(Node curNode, const Map &map, const EnvironmentOptions &options);
+        //Writes at most CN_MAX_SUCCESSORS successors of curNode to 'successors' and returns their number
+        virtual int findSuccessors(const Node &curNode, const Map &map, const EnvironmentOptions &options, Node *successors);
         virtual void makePrimaryPath(Node curNode);//Makes path using back pointers
         virtual void makeSecondaryPath();//Makes another type of path(sections or points)
         virtual Node resetParent(Node current, Node parent, const Map &map, const EnvironmentOptions &options) {return current;}//Function for Theta*
         virtual bool stopCriterion();
+        //Checked before every expansion, the clock is only read every 256 expansions
+        bool limitReached(unsigned int expansions, std::chrono::time_point<std::chrono::system_clock> start) const
+        {
+            if (maxexpansions && expansions >= maxexpansions)
+                return true;
+            return maxtime > 0 && (expansions & 255) == 0 &&
+                   std::chrono::duration<double, std::milli>(std::chrono::system_clock::now() - start).count() >= maxtime;
+        }
 
         SearchResult                    sresult;
         std::list<Node>                 lppath, hppath;
-        std::unordered_map<int,Node>    close;
-        std::vector<std::list<Node>>    open;
-        int                             openSize;
+        CellStateTable                  cells;//g, parent and OPEN/CLOSED status of every cell
+        OpenList                        open;
         double                          hweight;//weight of h-value
         bool                            breakingties;//flag that sets the priority of nodes in addOpen function when their F-values is equal
+        unsigned int                    maxexpansions;//limits of setLimits, 0 = none
+        double                          maxtime;
+        bool                            distanceonly;//set by setDistanceOnly, no path is made
 
 };
 #endif
@@ -0,0 +1,42 @@
+#ifndef JPS_H
+#define JPS_H
+#include "astar.h"
+#include "bitgrid.h"
+#include "goalbounds.h"
+
+//Jump Point Search. Successors are pruned by the canonical ordering of the active movement
+//rules and straight jumps scan 64 cells at a time over bit-packed rows (and columns).
+//With goal bounding, directions whose first move has goal bounds without the goal are not jumped.
+class JPS : public Astar
+{
+    public:
+        JPS(double hweight, bool breakingties, bool goalBounding = false, std::shared_ptr<const GoalBounds> bounds = nullptr)
+            :Astar(hweight, breakingties), grid(nullptr), goalBounding(goalBounding), bounds(bounds){}
+        ~JPS(void);
+        std::shared_ptr<const GoalBounds> getGoalBounds() const {return bounds;}
+
+    protected:
+        void initSearch(const Map &map, const EnvironmentOptions &options);
+        int findSuccessors(const Node &curNode, const Map &map, const EnvironmentOptions &options, Node *successors);
+        void makePrimaryPath(Node curNode);
+        void makeSecondaryPath();
+
+        int prunedDirections(const Node &curNode, int directions[8][2]) const;
+        bool canStep(int i, int j, int di, int dj) const;
+        bool hasForcedNeighbour(int i, int j, int di, int dj) const;//Checks cells reached by diagonal move (di, dj)
+        bool isStraightJumpPoint(int i, int j, int di, int dj) const;//Checks cells reached by straight move (di, dj)
+        virtual bool jump(int i, int j, int di, int dj, int &jump_i, int &jump_j) const;
+        bool jumpStraight(const BitGrid &scan, int row, int col, int dir, int goalRow, int goalCol, int &result) const;
+        bool jumpVertical(int i, int j, int di, int &jump_i) const;
+        void useGoalBounds(const Map &map, const EnvironmentOptions &options);//Builds them if they do not fit
+
+        const BitGrid   *grid;      //occupancy of the map, one bit per cell
+        BitGrid         columns;    //transposed occupancy, vertical jumps scan its rows
+        std::shared_ptr<const BitGrid> columnsSource;//grid 'columns' was built from
+        int             movement;   //CN_MR_* rules of the current search
+        int             goal_i, goal_j;
+        bool            goalBounding;
+        std::shared_ptr<const GoalBounds> bounds;
+};
+
+#endif // JPS_H
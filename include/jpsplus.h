@@ -0,0 +1,53 @@
+#ifndef JPSPLUS_H
+#define JPSPLUS_H
+#include "jps.h"
+#include <memory>
+
+#define CN_JT_MAX_DIST 32767 //Longer jumps are split by an intermediate jump point
+
+//Jump distances of every traversable cell in all 8 directions for one map and one set of movement rules.
+//A positive value d means the next jump point is d cells away, a value -d <= 0 means the jump
+//runs into an obstacle (or the border) after d cells.
+class JumpTable
+{
+    public:
+        JumpTable();
+
+        //Directions are numbered up, down, left, right, up-left, up-right, down-left, down-right
+        static int direction(int di, int dj)
+        {
+            static const int index[9] = {4, 0, 5, 2, -1, 3, 6, 1, 7};
+            return index[(di + 1) * 3 + dj + 1];
+        }
+        int distance(int i, int j, int dir) const {return distances[(static_cast<std::size_t>(i) * width + j) * 8 + dir];}
+        bool fits(const Map &map, const EnvironmentOptions &options) const;
+        std::size_t memoryUsage() const;
+
+        int                     height, width;
+        int                     movement;   //CN_MR_* rules the table was built for
+        double                  buildTime;  //seconds
+        std::shared_ptr<const BitGrid> grid;//occupancy the table was built from (shared with the map)
+        std::vector<int16_t>    distances;
+};
+
+//JPS+ answers jumps by looking them up in a JumpTable. The table is built on the first search
+//and reused by later searches on the same map, it can also be shared between several searches.
+class JPSPlus : public JPS
+{
+    public:
+        JPSPlus(double hweight, bool breakingties, std::shared_ptr<const JumpTable> table = nullptr,
+                bool goalBounding = false, std::shared_ptr<const GoalBounds> bounds = nullptr);
+        ~JPSPlus(void);
+
+        static std::shared_ptr<const JumpTable> preprocess(const Map &map, const EnvironmentOptions &options);
+        std::shared_ptr<const JumpTable> getJumpTable() const {return table;}
+
+    protected:
+        void initSearch(const Map &map, const EnvironmentOptions &options);
+        bool jump(int i, int j, int di, int dj, int &jump_i, int &jump_j) const;
+        std::shared_ptr<JumpTable> buildJumpTable(const Map &map, const EnvironmentOptions &options);
+
+        std::shared_ptr<const JumpTable> table;
+};
+
+#endif // JPSPLUS_H
@@ -0,0 +1,73 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+#include "astar.h"
+#include "components.h"
+#include <memory>
+#include <vector>
+#include <stdint.h>
+
+#define CN_LM_UNREACHABLE 0xFFFFFFFFu //distance of the cells a landmark cannot reach
+
+//Distances from a few landmark cells to every cell of one map for one set of movement rules, for the ALT
+//(differential) heuristic: by the triangle inequality |d(L, goal) - d(L, n)| is a lower bound on d(n, goal)
+//for every landmark L. On maze-like maps, where paths are much longer than straight lines, this bound is far
+//tighter than the octile distance.
+//The landmarks are placed by farthest-point selection in the largest connected component: each one is the
+//cell farthest (in moves) from those chosen before, so they end up in dead ends and at the borders. The
+//selection counts moves with breadth-first searches, then the exact distances of the landmarks are found with
+//Dijkstra searches that run in parallel. They are stored in steps of 'step' cells in 32 bits, cell by cell.
+//A neighbour can be one step further off in the table than its move costs, so a difference of k steps only bounds
+//the distance by k * step / (1 + step): with moves of cost 1 or more this keeps the heuristic consistent.
+class LandmarkTable
+{
+    public:
+        LandmarkTable();
+
+        //At most count (1..CN_LM_MAX) landmarks, the Dijkstra searches run on 'threads' workers (0 = one per hardware thread)
+        static std::shared_ptr<const LandmarkTable> build(const Map &map, const EnvironmentOptions &options, int count,
+                                                          int threads = 0);
+        bool fits(const Map &map, const EnvironmentOptions &options, int count) const;
+        std::size_t memoryUsage() const;
+        const uint32_t* distancesOf(int i, int j) const {return &distances[(static_cast<std::size_t>(i) * width + j) * count];}
+        //Largest of the landmark bounds on the distance between the cells whose rows of distances are given
+        double bound(const uint32_t *from, const uint32_t *to) const
+        {
+            uint32_t best = 0;
+            for (int k = 0; k < count; k++)
+                if (from[k] != CN_LM_UNREACHABLE && to[k] != CN_LM_UNREACHABLE)
+                    best = std::max(best, from[k] > to[k] ? from[k] - to[k] : to[k] - from[k]);
+            return best * scale;
+        }
+
+        int                             height, width;
+        int                             movement;   //CN_MR_* rules the table was built for
+        int                             requested;  //count asked for, more than count on small components
+        int                             count;      //number of landmarks
+        double                          step;       //distance of one unit of the table
+        double                          scale;      //step / (1 + step), the bound of one unit
+        double                          buildTime;  //seconds
+        std::shared_ptr<const BitGrid>  grid;       //occupancy the table was built from (shared with the map)
+        std::vector<int>                landmarks;  //cells (i * width + j)
+        std::vector<uint32_t>           distances;  //count values per cell
+};
+
+//A* with the larger of the metric and the landmark bound as heuristic. The landmark bound is a consistent lower
+//bound on grid paths (moves of cost 1 and sqrt(2)), so it keeps A* optimal with the octile or Euclidean metric.
+//The table is built on the first search and reused while it fits, like the JPS+ table.
+class ALTAstar : public Astar
+{
+    public:
+        ALTAstar(double HW, bool BT, int count, std::shared_ptr<const LandmarkTable> table = nullptr);
+        std::shared_ptr<const LandmarkTable> getLandmarkTable() const {return table;}
+
+    protected:
+        void initSearch(const Map &map, const EnvironmentOptions &options);
+        double computeHFromCellToCell(int i1, int j1, int i2, int j2, const EnvironmentOptions &options);
+
+        std::shared_ptr<const LandmarkTable>    table;
+        int                                     count;
+        int                                     goal_i, goal_j;
+        const uint32_t                          *goalDistances;
+};
+
+#endif // LANDMARKS_H
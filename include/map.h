@@ -2,28 +2,41 @@
 #define	MAP_H
 #include <iostream>
 #include "gl_const.h"
+#include "bitgrid.h"
 #include <sstream>
 #include <string>
 #include <algorithm>
 #include <vector>
+#include <memory>
+
+//Copies of a Map share its (read-only) occupancy grid, so one grid can serve many start/goal pairs
 class Map
 {
     public:
         Map();
-        Map(const Map& orig);
         ~Map();
 
-        bool getMap(const std::vector<std::vector<int>>& map, int startx, int starty, int finishx, int finishy, int cell_size);
-        bool CellIsTraversable (int i, int j) const;
+        bool getMap(const std::vector<std::vector<int>>& map, int startx, int starty, int finishx, int finishy, double cell_size);
+        //Same from a row-major height x width buffer, which is only read while the map is built
+        bool getMap(const signed char *map, int height, int width, int startx, int starty, int finishx, int finishy, double cell_size);
+        bool loadGrid(const signed char *map, int height, int width, double cell_size);//Grid only, set the endpoints later
+        //Keeps the grid, only changes start and goal. Blocked endpoints are printed if report is set
+        bool setEndpoints(int startx, int starty, int finishx, int finishy, bool report = false);
+        //Both checks accept the one-cell border around the grid (i = -1..height, j = -1..width), which is an obstacle
+        bool CellIsTraversable (int i, int j) const {return !Cells->isObstacle(i, j);}
+        bool CellIsObstacle(int i, int j) const {return Cells->isObstacle(i, j);}
         bool CellOnGrid (int i, int j) const;
-        bool CellIsObstacle(int i, int j) const;
         int  getValue(int i, int j) const;
+        const BitGrid& getGrid() const {return *Cells;}
+        const std::shared_ptr<const BitGrid>& getSharedGrid() const {return Cells;}
 
         int     height, width;
         int     start_i, start_j;
         int     goal_i, goal_j;
         double  cellSize;
-        const std::vector<std::vector<int>> *Grid;
+
+    private:
+        std::shared_ptr<const BitGrid> Cells;//occupancy, one bit per cell
 };
 
 #endif
@@ -0,0 +1,36 @@
+#ifndef METRICS_H
+#define METRICS_H
+#include "gl_const.h"
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+
+//Distance between cells that are di rows and dj columns apart, one policy per CN_SP_MT_* metric
+struct EuclidMetric
+{
+    static const int type = CN_SP_MT_EUCL;
+    static double distance(int di, int dj) {return sqrt(di * di + dj * dj);}
+};
+
+struct DiagonalMetric
+{
+    static const int type = CN_SP_MT_DIAG;
+    static double distance(int di, int dj)
+    {
+        return abs(abs(di) - abs(dj)) + sqrt(2) * std::min(abs(di), abs(dj));
+    }
+};
+
+struct ManhattanMetric
+{
+    static const int type = CN_SP_MT_MANH;
+    static double distance(int di, int dj) {return abs(di) + abs(dj);}
+};
+
+struct ChebyshevMetric
+{
+    static const int type = CN_SP_MT_CHEB;
+    static double distance(int di, int dj) {return std::max(abs(di), abs(dj));}
+};
+
+#endif // METRICS_H
@@ -8,7 +8,19 @@
 #include "environmentoptions.h"
 #include "astar.h"
 #include "theta.h"
+#include "jps.h"
+#include "jpsplus.h"
+#include "hpastar.h"
+#include "components.h"
+#include "pathdatabase.h"
+#include "landmarks.h"
+#include "contraction.h"
+#include "hublabels.h"
+#include "goalbounds.h"
+#include "subgoals.h"
+#include "preprocessing.h"
 #include "path_smoothing.h"
+#include <memory>
 
 class Mission
 {
@@ -17,18 +29,50 @@ class Mission
         Mission (const char* fileName);
         ~Mission();
 
-        bool getMap(int startX, int startY, int endX, int endY, int cellSize, std::vector<std::vector<int>> &mapData);
+        bool getMap(int startX, int startY, int endX, int endY, double cellSize, std::vector<std::vector<int>> &mapData);
+        bool getMap(int startX, int startY, int endX, int endY, double cellSize, const signed char *mapData, int height, int width);
+        bool getMap(int startX, int startY, int endX, int endY, const Map &loaded);//Shares the grid of a map loaded before
+        void getMap(const Map &loaded) {map = loaded;}//Same, keeping the endpoints of 'loaded'
         bool getConfig();
         void createSearch();
         void createEnvironmentOptions();
         void startSearch();
         void printSearchResultsToConsole();
         bool setDefaultConfig(bool use_theta);
+        bool setConfigParam(const std::string &tag, const std::string &value);
+        //False if the search type cannot keep the limits that are set: D* Lite repairs its search between calls,
+        //so it has no partial path to stop with
+        bool limitsSupported() const;
         void getPath(std::vector<std::vector<int>> &path);
         bool getPathValid();
+        bool getPathPartial() const {return sr.partial;}//Whether getPath gives the partial path of a search stopped by a limit
+        double getSuboptimality() const {return sr.suboptimality;}//Bound reported by an anytime search, 0 otherwise
+        void setVerbose(bool verbose) {this->verbose = verbose;}//Whether createSearch reports the algorithm
+        //Whether startSearch fails queries between different connected components at once. The labels take
+        //about as long to build as a search that fails, so this pays off when they are kept for many queries
+        void setComponentCheck(bool check) {componentCheck = check;}
+        //Component of cell (i, j) of the current map under the current movement rules, -1 for obstacles
+        int getComponent(int i, int j);
+        //Coarse HPA* path of the current map and config, refined by Theta* if the search type is an any-angle one.
+        //nullptr if the component check finds no path
+        std::unique_ptr<HierarchicalPath> planCoarse();
+        //Preprocessing of the map kept between searches (Planner shares it between its Missions)
+        const PreprocessingCache& getPreprocessing() const {return preprocessing;}
+        //Gives tables built or loaded elsewhere to later searches, they replace the ones kept so far
+        void setPreprocessing(const PreprocessingCache &cache) {preprocessing.merge(cache, true);}
+        //Table of the current map and movement rules, built on all cores if there is none that fits
+        template <class T> std::shared_ptr<const T> usePreprocessing();
+        //Builds the tables the configured search (and the component check) uses unless they fit the map, so that
+        //the workers of a batch find them instead of each building its own
+        void preprocess();
+        int getExpansions() const {return sr.numberofsteps;}
+        double getPathLength() const {return sr.pathlength;}//In cells, also set when CN_SP_DO leaves getPath empty
 
     private:
         const char* getAlgorithmName();
+        const ComponentLabels& useComponentLabels(double &buildTime);//Builds the labels if they do not fit the map
+        template <class T> std::shared_ptr<const T> kept() const {return preprocessing.get<T>(options.movementRules());}
+        template <class T> std::shared_ptr<const T> buildPreprocessing() const {return T::build(map, options);}
 
         Map                     map;
         Config                  config;
@@ -36,6 +80,24 @@ class Mission
         ISearch*                search;
         const char*             fileName;
         SearchResult            sr;
+        std::vector<double>     searchSettings;//parameters 'search' was created with
+        bool                    verbose;
+        bool                    componentCheck;
+        PreprocessingCache      preprocessing;
 };
 
+template <class T> std::shared_ptr<const T> Mission::usePreprocessing()
+{
+    std::shared_ptr<const T> table = kept<T>();
+    if (!table || !table->fits(map, options)) {
+        table = buildPreprocessing<T>();
+        preprocessing.set(options.movementRules(), table);
+    }
+    return table;
+}
+
+//Hub labels are made from the contraction hierarchy if there is one
+template <> std::shared_ptr<const HubLabels> Mission::buildPreprocessing<HubLabels>() const;
+template <> std::shared_ptr<const JumpTable> Mission::buildPreprocessing<JumpTable>() const;
+
 #endif
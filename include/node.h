@@ -5,7 +5,7 @@ struct Node
 {
     int     i, j;
     double  F, g, H;
-    Node    *parent;
+    int     parent; //index of the parent cell (i * width + j), -1 if there is none
 
     bool operator== (const Node &other) const {
         return i == other.i && j == other.j;
@@ -0,0 +1,153 @@
+#ifndef OPENLIST_H
+#define OPENLIST_H
+
+#include "node.h"
+#include "gl_const.h"
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+
+#define CN_OL_ARITY 4
+
+//Orders nodes by F, equal F-values are resolved by breakingties (chosen at run time)
+struct TieBreak
+{
+    TieBreak(bool BT = CN_SP_BT_GMAX) : breakingties(BT) {}
+    bool operator()(const Node &a, const Node &b) const
+    {
+        if (a.F != b.F)
+            return a.F < b.F;
+        if (breakingties == CN_SP_BT_GMAX)
+            return a.g > b.g;
+        return a.g < b.g;
+    }
+    bool breakingties;
+};
+
+//Same order with breakingties fixed at compile time
+template <bool GMax>
+struct FixedTieBreak
+{
+    bool operator()(const Node &a, const Node &b) const
+    {
+        if (a.F != b.F)
+            return a.F < b.F;
+        return GMax ? a.g > b.g : a.g < b.g;
+    }
+};
+
+//Indexed 4-ary min-heap used as OPEN. Every grid cell has a slot in 'position'
+//holding the index of its node inside the heap (or -1), so duplicate lookup is O(1)
+//and decrease-key is O(log n).
+template <class Order>
+class BasicOpenList
+{
+    public:
+        BasicOpenList() : width(0) {}
+
+        void reset(int height, int width);//Prepares the list for a new search on a height x width grid
+        void setOrder(const Order &order) {this->order = order;}
+        bool push(const Node &newNode);//Inserts the node or decreases its key, returns false if the node was discarded
+        void pop();
+        const Node& top() const {return heap.front();}
+        bool empty() const {return heap.empty();}
+        int size() const {return static_cast<int>(heap.size());}
+        const std::vector<Node>& nodes() const {return heap;}//In heap order
+        bool contains(int i, int j) const {return position[i * width + j] >= 0;}
+
+    private:
+        void siftUp(int pos);
+        void siftDown(int pos);
+        void place(const Node &node, int pos)
+        {
+            heap[pos] = node;
+            position[node.i * width + node.j] = pos;
+        }
+
+        std::vector<Node>   heap;
+        std::vector<int>    position;
+        int                 width;
+        Order               order;
+};
+
+typedef BasicOpenList<TieBreak> OpenList;
+
+template <class Order>
+void BasicOpenList<Order>::reset(int height, int width)
+{
+    //Only the slots of the nodes left in the heap are dirty, so there is no need to clear the whole grid
+    for (std::size_t k = 0; k < heap.size(); k++)
+        position[heap[k].i * this->width + heap[k].j] = -1;
+    heap.clear();
+    if (this->width != width || position.size() != static_cast<std::size_t>(height) * width) {
+        this->width = width;
+        position.assign(static_cast<std::size_t>(height) * width, -1);
+    }
+}
+
+template <class Order>
+void BasicOpenList<Order>::siftUp(int pos)
+{
+    Node node = heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / CN_OL_ARITY;
+        if (!order(node, heap[parent]))
+            break;
+        place(heap[parent], pos);
+        pos = parent;
+    }
+    place(node, pos);
+}
+
+template <class Order>
+void BasicOpenList<Order>::siftDown(int pos)
+{
+    Node node = heap[pos];
+    int size = static_cast<int>(heap.size());
+    while (true) {
+        int first = pos * CN_OL_ARITY + 1;
+        if (first >= size)
+            break;
+        int last = std::min(first + CN_OL_ARITY, size);
+        int best = first;
+        for (int child = first + 1; child < last; child++)
+            if (order(heap[child], heap[best]))
+                best = child;
+        if (!order(heap[best], node))
+            break;
+        place(heap[best], pos);
+        pos = best;
+    }
+    place(node, pos);
+}
+
+template <class Order>
+bool BasicOpenList<Order>::push(const Node &newNode)
+{
+    int pos = position[newNode.i * width + newNode.j];
+    if (pos >= 0) {
+        if (newNode.F >= heap[pos].F)
+            return false;
+        heap[pos] = newNode;
+        siftUp(pos);
+        return true;
+    }
+    heap.push_back(newNode);
+    siftUp(static_cast<int>(heap.size()) - 1);
+    return true;
+}
+
+template <class Order>
+void BasicOpenList<Order>::pop()
+{
+    position[heap.front().i * width + heap.front().j] = -1;
+    if (heap.size() > 1) {
+        heap.front() = heap.back();
+        heap.pop_back();
+        siftDown(0);
+    }
+    else
+        heap.pop_back();
+}
+
+#endif // OPENLIST_H
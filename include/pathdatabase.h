@@ -0,0 +1,65 @@
+#ifndef PATHDATABASE_H
+#define PATHDATABASE_H
+#include "astar.h"
+#include "components.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define CN_CPD_VERSION 1 //format of the files written by PathDatabase::save
+
+//Compressed path database (CPD) of one map for one set of movement rules: the first move of an optimal path
+//from every free cell to every other free cell.
+//The free cells are ranked along a Hilbert curve. For every source the first moves towards the targets are stored
+//in that order as runs of equal moves: nearby targets mostly share their first move, so a source takes a few
+//runs per obstacle it sees instead of one move per cell. Where several first moves are optimal the one that
+//continues the current run is kept, and targets that cannot be reached fit any run (the labelled components
+//answer whether there is a path).
+//Building costs one Dijkstra search per free cell (see Planner::savePreprocessing).
+class PathDatabase
+{
+    public:
+        PathDatabase();
+
+        //The sources are searched in parallel on 'threads' workers (0 = one per hardware thread)
+        static std::shared_ptr<const PathDatabase> build(const Map &map, const EnvironmentOptions &options, int threads = 0);
+        //Reads a database written by save(). nullptr if the file cannot be read or was built for another grid
+        static std::shared_ptr<const PathDatabase> load(const std::string &fileName, const Map &map);
+        bool save(const std::string &fileName) const;//Native byte order, false if the file cannot be written
+        bool fits(const Map &map, const EnvironmentOptions &options) const;
+        std::size_t memoryUsage() const;
+        //First move of an optimal path from cell (i1, j1) to cell (i2, j2) as an index into CPDSearch::moves,
+        //-1 if there is no path or the cells are the same
+        int firstMove(int i1, int j1, int i2, int j2) const;
+
+        int                                     height, width;
+        int                                     movement;   //CN_MR_* rules the database was built for
+        double                                  buildTime;  //seconds
+        std::shared_ptr<const BitGrid>          grid;       //occupancy the database was built from (shared with the map)
+        std::shared_ptr<const ComponentLabels>  labels;
+        std::vector<int32_t>                    rank;       //position of every cell on the curve among the free cells, -1 for obstacles
+        std::vector<uint64_t>                   offsets;    //runs of the source of rank r are runs[offsets[r]] .. runs[offsets[r + 1] - 1]
+        std::vector<uint32_t>                   runs;       //rank of the first target of a run << 3 | move
+
+    private:
+        void rankCells(std::vector<int> &cells);//Fills rank and returns the free cells (i * width + j) in curve order
+};
+
+//Follows the first moves of a PathDatabase from the start to the goal. Like the JPS+ table, the database is built
+//on the first search (or given) and reused while it fits the map. The metric and the heuristic weight are not used,
+//nor are the expansion and time limits: a query does one lookup per cell of the path.
+class CPDSearch : public Astar
+{
+    public:
+        CPDSearch(std::shared_ptr<const PathDatabase> database = nullptr);
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+        std::shared_ptr<const PathDatabase> getPathDatabase() const {return database;}
+
+        static const int moves[8][2];//same order as ISearch::findSuccessors
+
+    private:
+        std::shared_ptr<const PathDatabase> database;
+};
+
+#endif // PATHDATABASE_H
@@ -0,0 +1,165 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+#include "mission.h"
+#include <map>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+//Answers many start/goal queries on one map. The map is packed once and the search (with its buffers
+//and preprocessing such as the JPS+ jump table) is kept between queries, so a query only pays for the search.
+//plan() may be called from several threads at once: every running query takes its own Mission from a pool,
+//only the read-only grid and the JPS+ tables (and the other preprocessing) are shared.
+//Queries whose start and goal are not connected fail at once: the connected components of the map are labelled
+//on the first query for each movement rule set and kept like the JPS+ tables.
+//Points are in world coordinates: x = origin[0] + column * resolution, y = origin[1] + row * resolution.
+class Planner
+{
+    public:
+        typedef std::map<std::string, std::string> Options;//tag of the XML config (e.g. "searchtype") -> value
+
+        struct Query
+        {
+            std::vector<float> start, goal;
+        };
+
+        struct Result
+        {
+            int                 status;//0 if a path was found, 1 if a limit stopped the search with a partial path, -1 otherwise
+            std::vector<double> path;//x0, y0, x1, y1, ...
+            double              time;//milliseconds
+            double              suboptimality;//bound on length / optimal length reported by ARA*, 0 for other searches
+            int                 expansions;//nodes the search expanded
+            double              length;//of the path in world units, also with "distanceonly" (which leaves path empty)
+            Result() : status(-1), time(0), suboptimality(0), expansions(0), length(0) {}
+        };
+
+        //HPA* path whose segments are refined when they are asked for (see HierarchicalPath), in world coordinates
+        class CoarsePath
+        {
+            public:
+                CoarsePath(std::unique_ptr<HierarchicalPath> path, double origin_x, double origin_y, double resolution)
+                    : path(std::move(path)), origin_x(origin_x), origin_y(origin_y), resolution(resolution) {}
+
+                int segments() const {return path->segments();}
+                void waypoints(std::vector<double> &points) const;//x0, y0, x1, y1, ... of the coarse path
+                //Points of segment k, from waypoint k to waypoint k + 1. False if k is out of range or there is no path
+                bool refine(int k, std::vector<double> &points);
+
+            private:
+                std::unique_ptr<HierarchicalPath>   path;
+                double                              origin_x, origin_y;
+                double                              resolution;
+        };
+
+        //map points to map_size cells (row-major, dim[0] = width, dim[1] = height, 0 = free), it is only read here
+        Planner(const std::vector<float> &origin, const std::vector<int> &dim, const signed char *map, std::size_t map_size, double resolution);
+
+        static bool isValidOption(const std::string &tag, const std::string &value);
+        bool isLoaded() const {return loaded;}
+        bool setOption(const std::string &tag, const std::string &value);//Default for all later queries
+        //Turns the component check off for Planners that only answer one query, which would pay for the labels
+        //on every successful search; component() and components() label the map anyway
+        void setComponentCheck(bool check);
+        //Returns 0 if a path was found and -1 otherwise, options override the defaults for this query only.
+        //With a "maxexpansions" or "maxtime" limit it returns 1 if the limit stopped the search: the path then
+        //leads to the expanded cell closest to the goal.
+        //path receives the waypoints as x0, y0, x1, y1, ..., time_spent the planning time in milliseconds
+        int plan(const std::vector<float> &start, const std::vector<float> &goal, const Options &options,
+                 std::vector<double> &path, double &time_spent);
+        //Same with the answer in result, which also holds the suboptimality bound of an anytime search
+        int plan(const std::vector<float> &start, const std::vector<float> &goal, const Options &options, Result &result);
+        //Plans all queries on a work-stealing pool of 'threads' workers (0 = one per hardware thread).
+        //results[k] is the answer to queries[k], options apply to every query of the batch
+        void planBatch(const std::vector<Query> &queries, const Options &options, std::vector<Result> &results, int threads = 0);
+        //Plans the batch without landmarks and with the options (e.g. {"landmarks", "16"}) to show what the ALT
+        //heuristic saves: expansions[k] is the pair of expansions of query k. Queries that fail count 0
+        void expansionReport(const std::vector<Query> &queries, const Options &options,
+                             std::vector<std::pair<int, int>> &expansions, int threads = 0);
+        //Length of a shortest path of every query in world units, -1 where there is none: the batch is planned with
+        //"distanceonly", so no path is built. With searchtype "hl" a query is a single merge of two hub labels
+        void distances(const std::vector<Query> &queries, const Options &options, std::vector<double> &lengths,
+                       int threads = 0);
+        //Finds the coarse HPA* path only (building the abstract graph on the first call) and returns 0 and the path,
+        //or -1 if there is none. Its segments are refined with A*, or Theta* if the search type is theta, lazytheta
+        //or hpatheta.
+        //The path stays valid after the Planner is gone; refine one path from one thread at a time
+        int planCoarse(const std::vector<float> &start, const std::vector<float> &goal, const Options &options,
+                       std::unique_ptr<CoarsePath> &path, double &time_spent);
+
+        //Writes preprocessing of the map for the movement rules of the options to a file, building it first unless a
+        //query has: T is PathDatabase ("cpd"), ContractionHierarchy ("ch"), HubLabels ("hl", made from the hierarchy
+        //if there is one), GoalBounds ("goalbounding") or SubgoalGraph ("subgoal"). All of them are exact for octile
+        //moves (straight moves cost 1, diagonal ones sqrt(2)) and take up to a search per free cell to build, so they
+        //suit static maps: save them once per version of the map and load them with it afterwards.
+        //Files are in native byte order. False if the options are invalid or the file cannot be written
+        template <class T> bool savePreprocessing(const std::string &fileName, const Options &options);
+        //Reads a file written by savePreprocessing<T> for this map (on POSIX systems HubLabels map it instead), later
+        //queries with its movement rules use it. False if the file cannot be read or was built for another map
+        template <class T> bool loadPreprocessing(const std::string &fileName);
+
+        //Connected component of the cell under a point for the movement rules of the options, -1 if the point
+        //is outside the map or on an obstacle. Points can only reach each other if their components are equal
+        int component(const std::vector<float> &point, const Options &options);
+        //Same for the points x0, y0, x1, y1, ..., ids[k] is the component of point k
+        void components(const std::vector<float> &points, const Options &options, std::vector<int> &ids);
+
+        int getWidth() const {return map.width;}
+        int getHeight() const {return map.height;}
+
+    private:
+        Planner(const Planner &);
+        Planner& operator=(const Planner &);
+
+        bool toCell(const std::vector<float> &point, int &x, int &y) const;
+        int plan(Mission &mission, const Options &defaults, const std::vector<float> &start, const std::vector<float> &goal,
+                 const Options &options, Result &result);
+        //Gives the mission the map with the endpoints and the options of a query
+        bool setUp(Mission &mission, const Options &defaults, const std::vector<float> &start, const std::vector<float> &goal,
+                   const Options &options);
+        bool configure(Mission &mission, const Options &defaults, const Options &options);//Options only
+        std::unique_ptr<Mission> acquire(Options &defaults);//Takes an idle Mission (or makes one) and copies the defaults
+        void release(std::unique_ptr<Mission> mission);
+
+        Map         map;
+        double      origin_x, origin_y;
+        double      resolution;
+        bool        loaded;
+
+        std::mutex                              mutex;//guards everything below
+        Options                                 defaults;
+        bool                                    componentCheck;
+        std::vector<std::unique_ptr<Mission>>   idle;
+        PreprocessingCache                      preprocessing;//JPS+ tables and the other preprocessing of the map
+};
+
+template <class T> bool Planner::savePreprocessing(const std::string &fileName, const Options &options)
+{
+    if (!loaded)
+        return false;
+    Options defaults;
+    std::unique_ptr<Mission> mission = acquire(defaults);
+    mission->getMap(map);
+    std::shared_ptr<const T> table;
+    if (configure(*mission, defaults, options))
+        table = mission->usePreprocessing<T>();
+    release(std::move(mission));
+    return table && table->save(fileName);
+}
+
+template <class T> bool Planner::loadPreprocessing(const std::string &fileName)
+{
+    if (!loaded)
+        return false;
+    std::shared_ptr<const T> table = T::load(fileName, map);
+    if (!table)
+        return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    preprocessing.set(table);
+    return true;
+}
+
+#endif // PLANNER_H
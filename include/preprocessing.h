@@ -0,0 +1,61 @@
+#ifndef PREPROCESSING_H
+#define PREPROCESSING_H
+#include "gl_const.h"
+#include <memory>
+
+class JumpTable;
+class ClusterGraph;
+class ComponentLabels;
+class PathDatabase;
+class LandmarkTable;
+class ContractionHierarchy;
+class HubLabels;
+class GoalBounds;
+class SubgoalGraph;
+
+//Slot of every kind of preprocessing in a PreprocessingCache. A new kind only adds its line here
+template <class T> struct PreprocessingKind;
+template <> struct PreprocessingKind<JumpTable>             {enum {value = 0};};
+template <> struct PreprocessingKind<ClusterGraph>          {enum {value = 1};};
+template <> struct PreprocessingKind<ComponentLabels>       {enum {value = 2};};
+template <> struct PreprocessingKind<PathDatabase>          {enum {value = 3};};
+template <> struct PreprocessingKind<LandmarkTable>         {enum {value = 4};};
+template <> struct PreprocessingKind<ContractionHierarchy>  {enum {value = 5};};
+template <> struct PreprocessingKind<HubLabels>             {enum {value = 6};};
+template <> struct PreprocessingKind<GoalBounds>            {enum {value = 7};};
+template <> struct PreprocessingKind<SubgoalGraph>          {enum {value = 8};};
+#define CN_PP_COUNT 9
+
+//Preprocessing of one map for every kind and set of movement rules (JPS+ tables, HPA* graphs, path databases, ...),
+//kept between searches. The tables are const, so copies of the cache share them
+class PreprocessingCache
+{
+    public:
+        template <class T> std::shared_ptr<const T> get(int movement) const
+        {
+            return std::static_pointer_cast<const T>(tables[PreprocessingKind<T>::value][movement]);
+        }
+        template <class T> void set(int movement, std::shared_ptr<const T> table)
+        {
+            tables[PreprocessingKind<T>::value][movement] = table;
+        }
+        //Keeps the table for the movement rules it was built for, nothing if it is nullptr
+        template <class T> void set(std::shared_ptr<const T> table)
+        {
+            if (table)
+                set(table->movement, table);
+        }
+        //Takes the tables of 'other', only for the empty slots unless 'replace'
+        void merge(const PreprocessingCache &other, bool replace)
+        {
+            for (int kind = 0; kind < CN_PP_COUNT; kind++)
+                for (int k = 0; k < CN_MR_COUNT; k++)
+                    if (other.tables[kind][k] && (replace || !tables[kind][k]))
+                        tables[kind][k] = other.tables[kind][k];
+        }
+
+    private:
+        std::shared_ptr<const void> tables[CN_PP_COUNT][CN_MR_COUNT];
+};
+
+#endif // PREPROCESSING_H
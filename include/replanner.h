@@ -0,0 +1,44 @@
+#ifndef REPLANNER_H
+#define REPLANNER_H
+#include "dstarlite.h"
+#include "planner.h"
+
+//Plans again and again to one goal while the start moves and cells are found blocked or free, e.g. for a robot
+//that discovers its map while it drives. It keeps a D* Lite search on its own copy of the map, so a plan()
+//after a few changes only repairs the part of the search they touch. Points are in world coordinates as
+//for Planner. Not thread-safe: use one Replanner per robot, or call it from one thread at a time.
+class Replanner
+{
+    public:
+        //Options are those of Planner; only the movement rules are used, D* Lite ignores the metric and hweight
+        Replanner(const std::vector<float> &origin, const std::vector<int> &dim, const signed char *map, std::size_t map_size,
+                  double resolution, const std::vector<float> &start, const std::vector<float> &goal,
+                  const Planner::Options &options);
+
+        bool isLoaded() const {return loaded;}
+        bool setStart(const std::vector<float> &start);//False if the point is outside the map
+        bool setGoal(const std::vector<float> &goal);//Starts the search over, false if the point is outside the map
+        //Marks the cells under the points x0, y0, x1, y1, ... as blocked or free, returns how many points are on the map
+        int setCells(const std::vector<float> &points, bool blocked);
+        //Takes a whole new map of the same size, only the cells that changed are reported to the search
+        bool updateMap(const signed char *map, std::size_t map_size);
+        //Returns 0 if a path was found and -1 otherwise, path and time_spent as for Planner::plan
+        int plan(std::vector<double> &path, double &time_spent);
+        //Cells expanded by the last plan()
+        unsigned int getExpansions() const {return expansions;}
+
+        int getWidth() const {return width;}
+        int getHeight() const {return height;}
+
+    private:
+        bool toCell(const std::vector<float> &point, int &x, int &y) const;
+
+        DStarLite   search;
+        int         height, width;
+        double      origin_x, origin_y;
+        double      resolution;
+        bool        loaded;
+        unsigned int expansions;
+};
+
+#endif // REPLANNER_H
@@ -0,0 +1,47 @@
+#ifndef SEARCHKERNEL_H
+#define SEARCHKERNEL_H
+#include "theta.h"
+#include "metrics.h"
+#include <type_traits>
+
+//Whether the diagonal move (di, dj) from the free cell (i, j) is allowed by the movement rules (CN_MR_*)
+template <int Movement>
+inline bool diagonalMoveAllowed(const Map &map, int i, int j, int di, int dj)
+{
+    switch (Movement) {
+        case CN_MR_NOCORNER:
+            return map.CellIsTraversable(i, j + dj) && map.CellIsTraversable(i + di, j);
+        case CN_MR_CORNER:
+            return map.CellIsTraversable(i, j + dj) || map.CellIsTraversable(i + di, j);
+        case CN_MR_SQUEEZE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//A* (AnyAngle = false) or Theta* (AnyAngle = true) with the heuristic metric, the movement rules (CN_MR_*)
+//and the tie-breaking fixed at compile time. The main loop makes no virtual calls and has no branches
+//on search options; paths are built by the Astar/Theta base as usual.
+//Lazy (with AnyAngle) gives Lazy Theta*: a successor is linked to the parent of the expanded cell as if it could
+//see it, and the line of sight is only checked when the successor is expanded in turn. If it fails, the cell takes
+//its best closed neighbour as parent instead and goes back to OPEN if its F is no longer the smallest. Most generated
+//cells are never expanded, so far fewer lines are traced.
+template <class Metric, int Movement, bool GMax, bool AnyAngle, bool Lazy = false>
+class SearchKernel : public std::conditional<AnyAngle, Theta, Astar>::type
+{
+    typedef typename std::conditional<AnyAngle, Theta, Astar>::type Base;
+
+    public:
+        SearchKernel(double hweight):Base(hweight, GMax){}
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+
+    private:
+        BasicOpenList<FixedTieBreak<GMax>> heap;
+};
+
+//Returns the kernel matching the parameters or nullptr if the search type has no kernel
+//(only CN_SP_ST_ASTAR, CN_SP_ST_TH and CN_SP_ST_LTH have one)
+ISearch* createSearchKernel(int searchtype, int metrictype, int movement, bool breakingties, double hweight);
+
+#endif // SEARCHKERNEL_H
@@ -1,25 +1,39 @@
 #ifndef SEARCHRESULT_H
 #define SEARCHRESULT_H
 #include <list>
+#include <cstddef>
 #include "node.h"
 struct SearchResult
 {
         bool pathfound;
-        float pathlength; //if path not found, then pathlength=0
+        bool partial; //a limit stopped the search (pathfound = false), the paths lead to the expanded node closest to the goal
+        float pathlength; //if path not found, then pathlength=0 (length of the partial path if there is one)
         std::list<Node>* lppath;
         std::list<Node>* hppath;
         unsigned int nodescreated; //|OPEN| + |CLOSE| = total number of nodes saved in memory during search process.
         unsigned int numberofsteps; //number of iterations made by algorithm to find a solution
-        double time;
+        unsigned int forwardsteps, backwardsteps; //iterations of each direction of a bidirectional search (0 otherwise)
+        unsigned int lineofsightchecks; //line-of-sight tests made by any-angle searches (0 otherwise)
+        double suboptimality; //bound on pathlength / optimal length reported by anytime searches (0 otherwise)
+        double time; //search time, preprocessing done during the search is not included
+        double preprocessingtime; //time spent on building per-map tables during the search (0 if they were reused)
+        std::size_t preprocessingmemory; //size of the per-map tables used by the search, in bytes
         SearchResult()
         {
             pathfound = false;
+            partial = false;
             pathlength = 0;
             lppath = nullptr;
             hppath = nullptr;
             nodescreated = 0;
             numberofsteps = 0;
+            forwardsteps = 0;
+            backwardsteps = 0;
+            lineofsightchecks = 0;
+            suboptimality = 0;
             time = 0;
+            preprocessingtime = 0;
+            preprocessingmemory = 0;
         }
 
 };
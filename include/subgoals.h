@@ -0,0 +1,84 @@
+#ifndef SUBGOALS_H
+#define SUBGOALS_H
+#include "astar.h"
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#define CN_SG_VERSION   1   //format of the files written by SubgoalGraph::save
+#define CN_SG_SETTLED   200 //searches for paths around a subgoal give up after settling this many subgoals
+
+//Two-level subgoal graph of one map for one set of movement rules. Subgoals are the free cells at convex obstacle
+//corners, linked where an h-path (one diagonal and one straight direction) joins them. The local subgoals, which
+//no shortest path needs to pass, are contracted like CH cells, so queries only touch those next to their ends.
+class SubgoalGraph
+{
+    public:
+        //Per-worker buffers of reach() and refine()
+        struct Sweep
+        {
+            std::vector<int>        runs[2];//first and last y of every run of two rows
+            std::vector<uint8_t>    table;
+        };
+
+        SubgoalGraph();
+
+        //The subgoals are linked on 'threads' workers (0 = one per hardware thread)
+        static std::shared_ptr<const SubgoalGraph> build(const Map &map, const EnvironmentOptions &options, int threads = 0);
+        //Reads a graph written by save(). nullptr if the file cannot be read or was built for another grid
+        static std::shared_ptr<const SubgoalGraph> load(const std::string &fileName, const Map &map);
+        bool save(const std::string &fileName) const;//Native byte order, false if the file cannot be written
+        bool fits(const Map &map, const EnvironmentOptions &options) const;
+        std::size_t memoryUsage() const;
+        int nodes() const {return static_cast<int>(cells.size());}
+        //Cost of the shortest path between cells (di, dj) apart on an empty grid
+        double metric(int di, int dj) const;
+        //Appends to 'found' the subgoals that h-paths from the free cell (i, j) reach without passing another
+        //subgoal. True if one of these paths reaches the cell 'target' (i * width + j)
+        bool reach(const Map &map, int i, int j, int target, std::vector<int> &found, Sweep &sweep) const;
+        //Appends the cells after (i1, j1) on an h-path to (i2, j2) (i * width + j), false if there is none
+        bool refine(const Map &map, int i1, int j1, int i2, int j2, std::vector<int> &path, Sweep &sweep) const;
+
+        int                             height, width;
+        int                             movement;   //CN_MR_* rules the graph was built for
+        double                          buildTime;  //seconds
+        std::shared_ptr<const BitGrid>  grid;       //occupancy the graph was built from (shared with the map)
+        std::vector<int32_t>            node;       //subgoal of every cell, -1 for the others
+        std::vector<int32_t>            cells;      //cell (i * width + j) of every subgoal
+        std::vector<int32_t>            rows, columns;//i and j of every subgoal
+        std::vector<uint32_t>           first;      //links of subgoal v are links[first[v]] .. links[first[v + 1] - 1]
+        std::vector<int32_t>            links;      //sorted, to the subgoals that were global when v became local
+        std::vector<uint8_t>            local;      //1 for the local subgoals, which no global subgoal links to
+        std::vector<uint16_t>           clearance[4];//steps from every cell to the next obstacle or subgoal down, up, right, left
+
+    private:
+        void placeSubgoals();//Fills node, cells, rows, columns and clearance from the grid
+        bool moveAllowed(const Map &map, int i, int j, int di, int dj) const;
+};
+
+//A* on a SubgoalGraph with the start and the goal linked in, and the links turned back into moves. With
+//setDistanceOnly the links are not refined. Like the JPS+ table, the graph is built on the first search (or given)
+//and reused while it fits the map. Paths are shortest paths like those of A*; the metric, the heuristic weight and
+//the limits are not used.
+class SubgoalSearch : public Astar
+{
+    public:
+        SubgoalSearch(std::shared_ptr<const SubgoalGraph> graph = nullptr);
+        SearchResult startSearch(const Map &map, const EnvironmentOptions &options);
+        std::shared_ptr<const SubgoalGraph> getSubgoalGraph() const {return graph;}
+
+    private:
+        typedef std::pair<double, int> Entry;//f-value, node
+
+        std::shared_ptr<const SubgoalGraph> graph;
+        SubgoalGraph::Sweep                 sweep;
+        //Per node of the graph, with the start and the goal after the subgoals
+        std::vector<double>                 dist;
+        std::vector<int>                    parent, touched, startLinks, goalLinks, up;
+        std::vector<uint8_t>                toGoal, closed;//toGoal: 1 if the goal is linked, 2 if goalSide has links
+        std::vector<std::pair<int, int>>    goalSide;//subgoal, local subgoal below it on the way to the goal
+        std::vector<Entry>                  queue;//binary heap
+};
+
+#endif // SUBGOALS_H
@@ -8,6 +8,8 @@ class Theta: public Astar
         Theta(double hweight, bool breakingties):Astar(hweight, breakingties){}
         ~Theta(void);
         static bool lineOfSight(int i1, int j1, int i2, int j2, const Map &map, bool cutcorners);
+        template <bool CutCorners>
+        static bool lineOfSight(int i1, int j1, int i2, int j2, const Map &map);
         static double distance(int i1, int j1, int i2, int j2);
     protected:
         
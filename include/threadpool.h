@@ -0,0 +1,40 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+#include <functional>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//Work-stealing pool for a known number of independent tasks. Every worker starts with its own contiguous
+//block of task indices and takes them from the front; a worker that runs out steals the back half of the
+//largest remaining block, so long tasks do not leave the other workers idle.
+class ThreadPool
+{
+    public:
+        explicit ThreadPool(int threads = 0);//0 means one worker per hardware thread
+
+        int size() const {return threads;}
+        //Calls task(worker, index) for every index in [0, count) and returns when all calls are done.
+        //worker is in [0, size()), calls with the same worker never run at the same time.
+        //The first exception thrown by a task is rethrown here after all workers have stopped.
+        //A pool runs one batch at a time.
+        void run(int count, const std::function<void(int, int)> &task);
+
+    private:
+        struct Range
+        {
+            std::mutex  mutex;
+            int         begin, end;
+        };
+
+        bool next(int worker, int &index);//Takes the next index of the worker's block or steals a block
+        void work(int worker, const std::function<void(int, int)> &task);
+
+        int                                 threads;
+        std::vector<std::unique_ptr<Range>> ranges;
+        std::mutex                          errorMutex;
+        std::exception_ptr                  error;
+};
+
+#endif // THREADPOOL_H
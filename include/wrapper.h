@@ -1,4 +1,14 @@
 #pragma once
 #include <vector>
+#include <string>
+#include <cstddef>
+#include <map>
 
 int plan_2d(std::vector<float> &origin, std::vector<int> &dim, std::vector<signed char> &map, std::vector<float> &start, std::vector<float> &goal, float resolution, std::vector<std::vector<double> > &path, double &time_spent, bool use_theta);
+// searchtype is one of the names accepted by the 'searchtype' tag, the CNS_SP_ST_* values of gl_const.h ("astar", "jps", ...)
+int plan_2d(std::vector<float> &origin, std::vector<int> &dim, std::vector<signed char> &map, std::vector<float> &start, std::vector<float> &goal, float resolution, std::vector<std::vector<double> > &path, double &time_spent, const std::string &searchtype);
+// map points to map_size cells (row-major, dim[0] = width, dim[1] = height, 0 = free), it is only read, not copied.
+// path receives the waypoints as x0, y0, x1, y1, ...
+// options holds further config tags and values (e.g. "parallel" -> "true"), -1 is returned if one is not valid
+int plan_2d(const std::vector<float> &origin, const std::vector<int> &dim, const signed char *map, std::size_t map_size, const std::vector<float> &start, const std::vector<float> &goal, double resolution, std::vector<double> &path, double &time_spent, const std::string &searchtype,
+            const std::map<std::string, std::string> &options = std::map<std::string, std::string>());
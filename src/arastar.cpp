@@ -0,0 +1,207 @@
+#include "arastar.h"
+#include <limits>
+#include <algorithm>
+
+static const double CN_ARA_INF = std::numeric_limits<double>::infinity();
+
+ARAStar::ARAStar(double HW, bool BT, double deadline) : Astar(HW > 1 ? HW : CN_ARA_WEIGHT, BT)
+{
+    this->deadline = deadline;
+    width = 0;
+    goal = 0;
+    first = 0;
+    iteration = 0;
+    expansions = 0;
+}
+
+double ARAStar::gValue(int id) const
+{
+    return (state[id].stamp & CN_ARA_ITER) >= first ? state[id].g : CN_ARA_INF;
+}
+
+bool ARAStar::improvePath(const Map &map, const EnvironmentOptions &options, double weight, bool timed, Clock::time_point stop,
+                          std::chrono::time_point<std::chrono::system_clock> start)
+{
+    static const int moves[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+    int movement = options.movementRules();
+    while (!open.empty() && open.top().F < gValue(goal)) {
+        //The clock is read every 256 expansions only
+        if ((timed && (expansions & 255) == 0 && Clock::now() >= stop) || limitReached(expansions, start))
+            return false;
+        Node cur = open.top();
+        open.pop();
+        int curId = cur.i * width + cur.j;
+        state[curId].stamp = iteration | CN_ARA_CLOSED;
+        expansions++;
+        if (cur.H < closest.H)
+            closest = cur;
+        for (int k = 0; k < 8; k++) {
+            int di = moves[k][0], dj = moves[k][1];
+            bool diagonal = (di != 0 && dj != 0);
+            int i = cur.i + di, j = cur.j + dj;
+            if (!map.CellIsTraversable(i, j))
+                continue;
+            if (diagonal) {
+                bool first = map.CellIsTraversable(cur.i, cur.j + dj), second = map.CellIsTraversable(cur.i + di, cur.j);
+                if (movement == CN_MR_CARDINAL || (movement == CN_MR_NOCORNER && !(first && second)) ||
+                        (movement == CN_MR_CORNER && !(first || second)))
+                    continue;
+            }
+            int id = i * width + j;
+            //Rounded as it is stored, so an equal g is never taken for an improvement
+            float g = static_cast<float>(cur.g + (diagonal ? CN_SQRT_TWO : 1));
+            if (g >= gValue(id))
+                continue;
+            State &s = state[id];
+            s.g = g;
+            s.parent = curId;
+            if ((s.stamp & CN_ARA_ITER) != iteration)
+                s.stamp = iteration;
+            if (!(s.stamp & CN_ARA_CLOSED)) {
+                Node node;
+                node.i = i;
+                node.j = j;
+                node.g = g;
+                node.H = computeHFromCellToCell(i, j, map.goal_i, map.goal_j, options);
+                node.F = g + weight * node.H;
+                node.parent = curId;
+                open.push(node);
+            }
+            else if (!(s.stamp & CN_ARA_INCONS)) {
+                //Closed in this iteration already: it is reopened by the next one
+                s.stamp |= CN_ARA_INCONS;
+                incons.push_back(id);
+            }
+        }
+    }
+    return true;
+}
+
+double ARAStar::lowestF(const Map &map, const EnvironmentOptions &options)
+{
+    double lowest = CN_ARA_INF;
+    const std::vector<Node> &nodes = open.nodes();
+    for (std::size_t k = 0; k < nodes.size(); k++)
+        lowest = std::min(lowest, nodes[k].g + nodes[k].H);
+    for (std::size_t k = 0; k < incons.size(); k++) {
+        int i = incons[k] / width, j = incons[k] % width;
+        lowest = std::min(lowest, state[incons[k]].g + computeHFromCellToCell(i, j, map.goal_i, map.goal_j, options));
+    }
+    return lowest;
+}
+
+void ARAStar::reorderOpen(const Map &map, const EnvironmentOptions &options, double weight)
+{
+    buffer = open.nodes();
+    for (std::size_t k = 0; k < incons.size(); k++) {
+        Node node;
+        node.i = incons[k] / width;
+        node.j = incons[k] % width;
+        node.g = state[incons[k]].g;
+        node.H = computeHFromCellToCell(node.i, node.j, map.goal_i, map.goal_j, options);
+        node.parent = state[incons[k]].parent;
+        buffer.push_back(node);
+    }
+    incons.clear();
+    open.reset(map.height, map.width);
+    for (std::size_t k = 0; k < buffer.size(); k++) {
+        buffer[k].F = buffer[k].g + weight * buffer[k].H;
+        open.push(buffer[k]);
+    }
+}
+
+SearchResult ARAStar::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    Clock::time_point begin = Clock::now(), stop = begin + std::chrono::microseconds(static_cast<long long>(deadline * 1000));
+    std::chrono::time_point<std::chrono::system_clock> start = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    width = map.width;
+    std::size_t size = static_cast<std::size_t>(map.height) * map.width;
+    //Every search takes a few iterations (one per weight step), the stamps are cleared long before they run out
+    if (state.size() != size || iteration > CN_ARA_ITER / 2) {
+        State empty = {0, -1, 0};
+        state.assign(size, empty);
+        iteration = 0;
+    }
+    open.reset(map.height, map.width);
+    open.setOrder(TieBreak(breakingties));
+    incons.clear();
+    expansions = 0;
+    first = ++iteration;
+
+    int root = map.start_i * width + map.start_j;
+    goal = map.goal_i * width + map.goal_j;
+    State &s = state[root];
+    s.g = 0;
+    s.parent = -1;
+    s.stamp = iteration;
+    Node node;
+    node.i = map.start_i;
+    node.j = map.start_j;
+    node.g = 0;
+    node.H = computeHFromCellToCell(node.i, node.j, map.goal_i, map.goal_j, options);
+    node.F = hweight * node.H;
+    node.parent = -1;
+    open.push(node);
+    closest = node;
+
+    double weight = hweight, bound = CN_ARA_INF;
+    bool stopped = !improvePath(map, options, weight, false, stop, start);
+    while (gValue(goal) < CN_ARA_INF) {
+        //The path just found is within weight of the optimum (unless the limits stopped the first search), and within
+        //g(goal) / min(g + h) over the cells that could still lead to a shorter one
+        double lowest = lowestF(map, options);
+        bound = std::min(stopped ? CN_ARA_INF : weight, lowest < gValue(goal) ? gValue(goal) / lowest : 1.0);
+        if (stopped || bound <= 1 || (deadline > 0 && Clock::now() >= stop))
+            break;
+        weight = std::max(1.0, weight - CN_ARA_STEP);
+        reorderOpen(map, options, weight);
+        iteration++;
+        if (!improvePath(map, options, weight, deadline > 0, stop, start))
+            break;
+    }
+
+    sresult.numberofsteps = expansions;
+    sresult.nodescreated = expansions + open.size();
+    //Without a path the limits stopped the first search, which leaves a partial path to the closest cell
+    int last = gValue(goal) < CN_ARA_INF ? goal : (stopped ? closest.i * width + closest.j : -1);
+    if (last >= 0) {
+        //Parents only change when a g-value drops, so the pointers always lead back to the start
+        double length = 0;
+        if (distanceonly) {
+            for (int id = last; state[id].parent >= 0; id = state[id].parent) {
+                int parent = state[id].parent;
+                length += (id / width != parent / width && id % width != parent % width) ? CN_SQRT_TWO : 1;
+            }
+        }
+        else {
+            for (int id = last; id >= 0; id = state[id].parent) {
+                node.i = id / width;
+                node.j = id % width;
+                node.parent = state[id].parent;
+                lppath.push_front(node);
+            }
+            std::list<Node>::iterator prev = lppath.begin();
+            prev->g = 0;
+            for (std::list<Node>::iterator it = std::next(prev); it != lppath.end(); prev = it++) {
+                length += (it->i != prev->i && it->j != prev->j) ? CN_SQRT_TWO : 1;
+                it->g = length;
+            }
+        }
+        sresult.pathfound = (last == goal);
+        sresult.partial = (last != goal);
+        sresult.pathlength = length;
+        if (last == goal)
+            sresult.suboptimality = bound;
+    }
+    sresult.time = std::chrono::duration<double>(Clock::now() - begin).count();
+    if (lppath.size() > 2)
+        makeSecondaryPath();
+    else
+        hppath = lppath;
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
@@ -1,4 +1,5 @@
 #include "astar.h"
+#include "metrics.h"
 
 Astar::Astar(double HW, bool BT)
 {
@@ -10,13 +11,13 @@ double Astar::computeHFromCellToCell(int i1, int j1, int i2, int j2, const Envir
 {
     switch (options.metrictype) {
         case CN_SP_MT_EUCL:
-            return (sqrt((i2 - i1)*(i2 - i1)+(j2 - j1)*(j2 - j1)));
+            return EuclidMetric::distance(i2 - i1, j2 - j1);
         case CN_SP_MT_DIAG:
-            return (abs(abs(i2 - i1) - abs(j2 - j1)) + sqrt(2) * (std::min(abs(i2 - i1),abs(j2 - j1))));
+            return DiagonalMetric::distance(i2 - i1, j2 - j1);
         case CN_SP_MT_MANH:
-            return (abs(i2 - i1) + abs(j2 - j1));
+            return ManhattanMetric::distance(i2 - i1, j2 - j1);
         case CN_SP_MT_CHEB:
-            return std::max(abs(i2 - i1),abs(j2 - j1));
+            return ChebyshevMetric::distance(i2 - i1, j2 - j1);
         default:
             return 0;
     }
@@ -0,0 +1,297 @@
+#include "bidirectional.h"
+#include <chrono>
+#include <limits>
+#include <thread>
+#include <cstring>
+
+BidirectionalAstar::BidirectionalAstar(double HW, bool BT, bool dijkstra, bool parallel) : Astar(HW, BT)
+{
+    this->dijkstra = dijkstra;
+    this->parallel = parallel;
+    meeting = -1;
+    closestH = 0;
+    for (int side = 0; side < 2; side++) {
+        frontiers[side].reachedSize = 0;
+        frontiers[side].generation = 0;
+    }
+}
+
+double BidirectionalAstar::computeHFromCellToCell(int i1, int j1, int i2, int j2, const EnvironmentOptions &options)
+{
+    if (dijkstra)
+        return 0;
+    return Astar::computeHFromCellToCell(i1, j1, i2, j2, options);
+}
+
+static inline uint64_t packG(uint32_t generation, double g)
+{
+    float value = static_cast<float>(g);
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return static_cast<uint64_t>(generation) << 32 | bits;
+}
+
+static inline float unpackG(uint64_t packed)
+{
+    uint32_t bits = static_cast<uint32_t>(packed);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+//The movement rules are symmetric, so the backward direction uses the same moves
+static inline bool diagonalAllowed(const Map &map, const EnvironmentOptions &options, int i, int j, int di, int dj)
+{
+    if (!options.allowdiagonal)
+        return false;
+    if (!options.cutcorners)
+        return map.CellIsTraversable(i, j + dj) && map.CellIsTraversable(i + di, j);
+    if (!options.allowsqueeze)
+        return map.CellIsTraversable(i, j + dj) || map.CellIsTraversable(i + di, j);
+    return true;
+}
+
+Node BidirectionalAstar::startFrontier(int side, int i, int j, int target_i, int target_j, const Map &map, const EnvironmentOptions &options)
+{
+    Frontier &self = frontiers[side];
+    self.cells.reset(map.height, map.width);
+    self.open.reset(map.height, map.width);
+    self.open.setOrder(TieBreak(breakingties));
+    self.target_i = target_i;
+    self.target_j = target_j;
+    self.expansions = 0;
+    if (parallel) {
+        //Entries of previous searches have an older generation, so the array is only cleared when it is reallocated
+        std::size_t size = static_cast<std::size_t>(map.height) * map.width;
+        self.generation++;
+        if (self.reachedSize != size || self.generation == CN_BD_CLOSED) {
+            self.reached.reset(new std::atomic<uint64_t>[size]);
+            for (std::size_t k = 0; k < size; k++)
+                self.reached[k].store(0, std::memory_order_relaxed);
+            self.reachedSize = size;
+            self.generation = 1;
+        }
+    }
+    Node node;
+    node.i = i;
+    node.j = j;
+    node.g = 0;
+    node.H = computeHFromCellToCell(i, j, target_i, target_j, options);
+    node.F = hweight * node.H;
+    node.parent = -1;
+    self.minF.store(node.F);
+    return node;
+}
+
+template <bool Parallel>
+void BidirectionalAstar::setOpen(int side, const Node &node, int id)
+{
+    Frontier &self = frontiers[side], &other = frontiers[1 - side];
+    if (!self.open.push(node))
+        return;
+    self.cells.setOpen(id, node.g, node.parent);
+    double otherG;
+    if (Parallel) {
+        //Both directions store their own g before loading the other one (sequentially consistent),
+        //so whichever reaches a cell last sees the g of the other
+        self.reached[id].store(packG(self.generation, node.g));
+        uint64_t packed = other.reached[id].load();
+        if ((packed >> 32 & ~CN_BD_CLOSED) != other.generation)
+            return;
+        otherG = unpackG(packed);
+    }
+    else {
+        if (!other.cells.isVisited(id))
+            return;
+        otherG = other.cells[id].g;
+    }
+    if (node.g + otherG < best.load())
+        meet(node.g + otherG, id);
+}
+
+void BidirectionalAstar::meet(double length, int id)
+{
+    std::lock_guard<std::mutex> lock(meetMutex);
+    if (length < best.load()) {
+        best.store(length);
+        meeting = id;
+    }
+}
+
+template <bool Parallel>
+bool BidirectionalAstar::expand(int side, const Map &map, const EnvironmentOptions &options)
+{
+    Frontier &self = frontiers[side], &other = frontiers[1 - side];
+    if (self.open.empty())
+        return false;
+    Node curNode = self.open.top();
+    //No path through a cell still in this OPEN list can be shorter than the best one
+    double bound = best.load();
+    if (curNode.F >= bound || (dijkstra && curNode.F + other.minF.load(std::memory_order_relaxed) >= bound))
+        return false;
+    self.open.pop();
+    int curId = self.cells.index(curNode.i, curNode.j);
+    self.cells.setClosed(curId);
+    self.expansions++;
+    if (side == 0 && (maxexpansions || maxtime > 0)) {
+        //Bidirectional Dijkstra has no H, the partial path needs the distance to the goal all the same
+        double h = dijkstra ? Astar::computeHFromCellToCell(curNode.i, curNode.j, map.goal_i, map.goal_j, options) : curNode.H;
+        if (h < closestH) {
+            closestH = h;
+            closest = curNode;
+        }
+    }
+    //A cell closed by the other direction already has its best path through it counted in 'best' (nipping)
+    bool otherClosed;
+    if (Parallel) {
+        self.reached[curId].store(packG(self.generation | CN_BD_CLOSED, curNode.g));
+        otherClosed = (other.reached[curId].load() >> 32 == (other.generation | CN_BD_CLOSED));
+    }
+    else
+        otherClosed = other.cells.isClosed(curId);
+    if (otherClosed) {
+        updateMinF(self);
+        return true;
+    }
+    for (int di = +1; di >= -1; di--)
+        for (int dj = +1; dj >= -1; dj--) {
+            if ((di == 0 && dj == 0) || !map.CellIsTraversable(curNode.i + di, curNode.j + dj))
+                continue;
+            bool diagonal = (di != 0 && dj != 0);
+            if (diagonal && !diagonalAllowed(map, options, curNode.i, curNode.j, di, dj))
+                continue;
+            int id = self.cells.index(curNode.i + di, curNode.j + dj);
+            if (self.cells.isClosed(id))
+                continue;
+            Node newNode;
+            newNode.i = curNode.i + di;
+            newNode.j = curNode.j + dj;
+            newNode.g = curNode.g + (diagonal ? sqrt(2) : 1);
+            newNode.H = computeHFromCellToCell(newNode.i, newNode.j, self.target_i, self.target_j, options);
+            newNode.F = newNode.g + hweight * newNode.H;
+            //Paths through the cell cannot be shorter than F, so it is not needed once F reaches 'best' (trimming)
+            if (newNode.F >= best.load(std::memory_order_relaxed))
+                continue;
+            newNode.parent = curId;
+            setOpen<Parallel>(side, newNode, id);
+        }
+    updateMinF(self);
+    return true;
+}
+
+void BidirectionalAstar::updateMinF(Frontier &self)
+{
+    self.minF.store(self.open.empty() ? std::numeric_limits<double>::infinity() : self.open.top().F,
+                    std::memory_order_relaxed);
+}
+
+void BidirectionalAstar::runParallel(int side, const Map &map, const EnvironmentOptions &options,
+                                     std::chrono::time_point<std::chrono::system_clock> start)
+{
+    while (!finished.load(std::memory_order_relaxed)) {
+        //Each direction counts its own expansions twice, so the two together keep to the limit
+        if (limitReached(2 * frontiers[side].expansions, start)) {
+            stopped.store(true);
+            break;
+        }
+        if (!expand<true>(side, map, options))
+            break;
+    }
+    finished.store(true);
+}
+
+SearchResult BidirectionalAstar::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    best.store(std::numeric_limits<double>::infinity());
+    meeting = -1;
+    finished.store(false);
+    stopped.store(false);
+    //Both roots are added after both directions are reset, so a search with start == goal meets at once
+    Node roots[2] = {startFrontier(0, map.start_i, map.start_j, map.goal_i, map.goal_j, map, options),
+                     startFrontier(1, map.goal_i, map.goal_j, map.start_i, map.start_j, map, options)};
+    closest = roots[0];
+    closestH = Astar::computeHFromCellToCell(map.start_i, map.start_j, map.goal_i, map.goal_j, options);
+    for (int side = 0; side < 2; side++) {
+        int id = frontiers[side].cells.index(roots[side].i, roots[side].j);
+        if (parallel)
+            setOpen<true>(side, roots[side], id);
+        else
+            setOpen<false>(side, roots[side], id);
+    }
+
+    if (parallel) {
+        std::thread backward(&BidirectionalAstar::runParallel, this, 1, std::cref(map), std::cref(options), start);
+        runParallel(0, map, options, start);
+        backward.join();
+    }
+    else {
+        //The direction with the smaller OPEN list goes next, so the two searches stay balanced
+        while (true) {
+            if (limitReached(frontiers[0].expansions + frontiers[1].expansions, start)) {
+                stopped.store(true);
+                break;
+            }
+            if (!expand<false>(frontiers[0].open.size() <= frontiers[1].open.size() ? 0 : 1, map, options))
+                break;
+        }
+    }
+
+    sresult.forwardsteps = frontiers[0].expansions;
+    sresult.backwardsteps = frontiers[1].expansions;
+    sresult.numberofsteps = sresult.forwardsteps + sresult.backwardsteps;
+    sresult.nodescreated = sresult.numberofsteps + frontiers[0].open.size() + frontiers[1].open.size();
+    //A path found before the limits were reached leads to the goal, but it may not be the shortest one
+    if (meeting >= 0) {
+        sresult.pathfound = !stopped.load();
+        sresult.partial = stopped.load();
+        if (!distanceonly)
+            makePath(meeting);
+        sresult.pathlength = frontiers[0].cells[meeting].g + frontiers[1].cells[meeting].g;
+    }
+    else if (stopped.load()) {
+        sresult.partial = true;
+        if (!distanceonly)
+            makePath(frontiers[0].cells.index(closest.i, closest.j));
+        sresult.pathlength = closest.g;
+    }
+    //Stop the timer now because making path using back pointers is a part of the algorithm
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
+    if ((sresult.pathfound || sresult.partial) && !distanceonly)
+        makeSecondaryPath();
+
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
+
+void BidirectionalAstar::makePath(int last)
+{
+    //The forward half is read from the last cell back to the start, the backward half from the meeting cell on to the goal
+    const CellStateTable &forward = frontiers[0].cells, &backward = frontiers[1].cells;
+    Node node = forward.node(last);
+    lppath.push_front(node);
+    while (node.parent >= 0) {
+        node = forward.node(node.parent);
+        lppath.push_front(node);
+    }
+    if (last != meeting)
+        return;
+    double length = forward[meeting].g + backward[meeting].g;
+    int previous = meeting;
+    node = backward.node(meeting);
+    while (node.parent >= 0) {
+        int id = node.parent;
+        node = backward.node(id);
+        Node step = node;
+        step.g = length - node.g;
+        step.parent = previous;
+        lppath.push_back(step);
+        previous = id;
+    }
+}
@@ -0,0 +1,71 @@
+#include "bitgrid.h"
+#include <algorithm>
+
+BitGrid::BitGrid()
+{
+    height = 0;
+    width = 0;
+    stride = 0;
+}
+
+void BitGrid::assign(int height, int width)
+{
+    this->height = height;
+    this->width = width;
+    stride = (width + 2 + 63) / 64;
+    bits.assign(static_cast<std::size_t>(height + 2) * stride, ~uint64_t(0));
+    //Every inner row only keeps the border bit in front of column 0 and the padding behind the last column
+    std::vector<uint64_t> inner(stride, 0);
+    inner[0] = 1;
+    for (int pos = width + 1; pos < stride * 64; pos++)
+        inner[pos >> 6] |= uint64_t(1) << (pos & 63);
+    for (int i = 0; i < height; i++)
+        std::copy(inner.begin(), inner.end(), bits.begin() + static_cast<std::size_t>(i + 1) * stride);
+}
+
+void BitGrid::setObstacle(int i, int j, bool obstacle)
+{
+    int pos = j + 1;
+    uint64_t &word = bits[static_cast<std::size_t>(i + 1) * stride + (pos >> 6)];
+    if (obstacle)
+        word |= uint64_t(1) << (pos & 63);
+    else
+        word &= ~(uint64_t(1) << (pos & 63));
+}
+
+void BitGrid::transpose(BitGrid &result) const
+{
+    result.assign(width, height);
+    //Only obstacles have to be copied, so walk the set bits of every row skipping border and padding
+    for (int i = 0; i < height; i++) {
+        const uint64_t *words = row(i);
+        for (int w = 0; w < stride; w++) {
+            uint64_t word = words[w];
+            if (w == 0)
+                word &= ~uint64_t(1);
+            while (word) {
+                int j = w * 64 + lowestBit(word) - 1;
+                if (j >= width)
+                    break;
+                result.setObstacle(j, i, true);
+                word &= word - 1;
+            }
+        }
+    }
+}
+
+uint64_t BitGrid::fingerprint() const
+{
+    uint64_t hash = 14695981039346656037ULL;
+    std::vector<uint64_t> words;
+    words.push_back(static_cast<uint64_t>(height));
+    words.push_back(static_cast<uint64_t>(width));
+    for (int i = 0; i < height; i++)
+        words.insert(words.end(), row(i), row(i) + stride);
+    for (std::size_t k = 0; k < words.size(); k++)
+        for (int shift = 0; shift < 64; shift += 8) {
+            hash ^= (words[k] >> shift) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    return hash;
+}
@@ -0,0 +1,44 @@
+#include "cellstate.h"
+#include <cstddef>
+
+CellStateTable::CellStateTable()
+{
+    height = 0;
+    width = 0;
+    generation = 0;
+}
+
+void CellStateTable::reset(int height, int width)
+{
+    std::size_t size = static_cast<std::size_t>(height) * width;
+    generation = (generation + 1) & CN_CS_GEN_MASK;
+    if (cells.size() != size || generation == 0) {
+        CellState unvisited;
+        unvisited.g = 0;
+        unvisited.parent = -1;
+        unvisited.stamp = 0;
+        cells.assign(size, unvisited);
+        generation = 1;
+    }
+    this->height = height;
+    this->width = width;
+}
+
+void CellStateTable::setOpen(int id, double g, int parent)
+{
+    cells[id].g = static_cast<float>(g);
+    cells[id].parent = parent;
+    cells[id].stamp = generation | CN_CS_OPEN;
+}
+
+Node CellStateTable::node(int id) const
+{
+    Node result;
+    result.i = id / width;
+    result.j = id % width;
+    result.g = cells[id].g;
+    result.F = result.g;
+    result.H = 0;
+    result.parent = cells[id].parent;
+    return result;
+}
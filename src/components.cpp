@@ -0,0 +1,112 @@
+#include "components.h"
+#include <chrono>
+
+ComponentLabels::ComponentLabels()
+{
+    height = 0;
+    width = 0;
+    diagonal = false;
+    count = 0;
+    buildTime = 0;
+}
+
+bool ComponentLabels::fits(const Map &map, const EnvironmentOptions &options) const
+{
+    return diagonal == diagonalFor(options.movementRules()) && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t ComponentLabels::memoryUsage() const
+{
+    return labels.size() * sizeof(int32_t);
+}
+
+//First bit position at or after pos that is set (obstacle) or clear (free) in a row of the grid
+static int nextBit(const uint64_t *words, int stride, int pos, bool set)
+{
+    int w = pos >> 6;
+    if (w >= stride)
+        return stride * 64;
+    uint64_t word = (set ? words[w] : ~words[w]) & (~uint64_t(0) << (pos & 63));
+    while (!word) {
+        if (++w == stride)
+            return stride * 64;
+        word = set ? words[w] : ~words[w];
+    }
+    return w * 64 + lowestBit(word);
+}
+
+static int findRoot(std::vector<int> &parent, int x)
+{
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+std::shared_ptr<const ComponentLabels> ComponentLabels::build(const Map &map, int movement)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<ComponentLabels> result = std::make_shared<ComponentLabels>();
+    result->height = map.height;
+    result->width = map.width;
+    result->diagonal = diagonalFor(movement);
+    result->grid = map.getSharedGrid();
+    const BitGrid &grid = *result->grid;
+
+    //The free runs of every row are joined with the runs of the row above that touch them (union-find on runs),
+    //then each run is filled with the number of its component
+    struct Run
+    {
+        int begin, end;//columns [begin, end)
+    };
+    std::vector<Run> runs;
+    std::vector<std::size_t> rowStart(map.height + 1, 0);
+    std::vector<int> parent;
+    int reach = result->diagonal ? 1 : 0;
+    for (int i = 0; i < map.height; i++) {
+        rowStart[i] = runs.size();
+        const uint64_t *words = grid.row(i);
+        //Bit position p holds column p - 1, the border and the padding are obstacles
+        for (int pos = nextBit(words, grid.stride, 1, false); pos < grid.stride * 64;
+                 pos = nextBit(words, grid.stride, pos, false)) {
+            int end = nextBit(words, grid.stride, pos, true);
+            Run run = {pos - 1, end - 1};
+            int id = static_cast<int>(runs.size());
+            runs.push_back(run);
+            parent.push_back(id);
+            pos = end;
+        }
+        if (i == 0)
+            continue;
+        std::size_t above = rowStart[i - 1], last = rowStart[i];
+        for (std::size_t k = rowStart[i]; k < runs.size(); k++) {
+            while (above < last && runs[above].end + reach <= runs[k].begin)
+                above++;
+            for (std::size_t a = above; a < last && runs[a].begin < runs[k].end + reach; a++) {
+                int x = findRoot(parent, static_cast<int>(a)), y = findRoot(parent, static_cast<int>(k));
+                if (x != y)
+                    parent[std::max(x, y)] = std::min(x, y);
+            }
+        }
+    }
+    rowStart[map.height] = runs.size();
+
+    //Roots have the smallest run id of their component, so numbering them in order gives consecutive labels
+    std::vector<int> component(runs.size());
+    int count = 0;
+    for (std::size_t k = 0; k < runs.size(); k++) {
+        int root = findRoot(parent, static_cast<int>(k));
+        component[k] = (root == static_cast<int>(k)) ? count++ : component[root];
+    }
+    result->count = count;
+    result->labels.assign(static_cast<std::size_t>(map.height) * map.width, -1);
+    for (int i = 0; i < map.height; i++) {
+        int32_t *row = &result->labels[static_cast<std::size_t>(i) * map.width];
+        for (std::size_t k = rowStart[i]; k < rowStart[i + 1]; k++)
+            std::fill(row + runs[k].begin, row + runs[k].end, component[k]);
+    }
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
@@ -17,12 +17,19 @@ Config::~Config()
     if (SearchParams) delete[] SearchParams;
 }
 
+// The parameter array is allocated once and reused when the configuration is set again
+void Config::allocateParams()
+{
+    if (SearchParams)
+        return;
+    N = 16;
+    SearchParams = new double[N];
+}
+
 // Set configuration parameters directly, instead of reading from XML
 void Config::setConfig(int st, double hw, int mt, int bt, int ad, int cc, int asq, int ps)
 {
-    if (SearchParams) delete[] SearchParams;
-    N = 8;
-    SearchParams = new double[N];
+    allocateParams();
     SearchParams[CN_SP_ST] = st;
     SearchParams[CN_SP_HW] = hw;
     SearchParams[CN_SP_MT] = mt;
@@ -31,6 +38,14 @@ void Config::setConfig(int st, double hw, int mt, int bt, int ad, int cc, int as
     SearchParams[CN_SP_CC] = cc;
     SearchParams[CN_SP_AS] = asq;
     SearchParams[CN_SP_PS] = ps;
+    SearchParams[CN_SP_FP] = 0;
+    SearchParams[CN_SP_PAR] = 0;
+    SearchParams[CN_SP_DL] = 0;
+    SearchParams[CN_SP_EL] = 0;
+    SearchParams[CN_SP_TL] = 0;
+    SearchParams[CN_SP_LM] = 0;
+    SearchParams[CN_SP_DO] = 0;
+    SearchParams[CN_SP_GB] = 0;
 }
 
 // Set a parameter by tag name (as in gl_const.h) and string value (for bools and enums)
@@ -42,6 +57,19 @@ bool Config::setParamByTag(const std::string& tag, const std::string& value)
     if (tag == CNS_TAG_ST) {
         if (v == CNS_SP_ST_ASTAR) { SearchParams[CN_SP_ST] = CN_SP_ST_ASTAR; return true; }
         if (v == CNS_SP_ST_TH)    { SearchParams[CN_SP_ST] = CN_SP_ST_TH;    return true; }
+        if (v == CNS_SP_ST_JPS)   { SearchParams[CN_SP_ST] = CN_SP_ST_JPS;   return true; }
+        if (v == CNS_SP_ST_JPSPLUS) { SearchParams[CN_SP_ST] = CN_SP_ST_JPSPLUS; return true; }
+        if (v == CNS_SP_ST_BASTAR) { SearchParams[CN_SP_ST] = CN_SP_ST_BASTAR; return true; }
+        if (v == CNS_SP_ST_BDIJKSTRA) { SearchParams[CN_SP_ST] = CN_SP_ST_BDIJKSTRA; return true; }
+        if (v == CNS_SP_ST_HPASTAR) { SearchParams[CN_SP_ST] = CN_SP_ST_HPASTAR; return true; }
+        if (v == CNS_SP_ST_HPATHETA) { SearchParams[CN_SP_ST] = CN_SP_ST_HPATHETA; return true; }
+        if (v == CNS_SP_ST_LTH) { SearchParams[CN_SP_ST] = CN_SP_ST_LTH; return true; }
+        if (v == CNS_SP_ST_DSL) { SearchParams[CN_SP_ST] = CN_SP_ST_DSL; return true; }
+        if (v == CNS_SP_ST_ARA) { SearchParams[CN_SP_ST] = CN_SP_ST_ARA; return true; }
+        if (v == CNS_SP_ST_CPD) { SearchParams[CN_SP_ST] = CN_SP_ST_CPD; return true; }
+        if (v == CNS_SP_ST_CH)  { SearchParams[CN_SP_ST] = CN_SP_ST_CH;  return true; }
+        if (v == CNS_SP_ST_HL)  { SearchParams[CN_SP_ST] = CN_SP_ST_HL;  return true; }
+        if (v == CNS_SP_ST_SUB) { SearchParams[CN_SP_ST] = CN_SP_ST_SUB; return true; }
         return false;
     }
     if (tag == CNS_TAG_MT) {
@@ -51,17 +79,30 @@ bool Config::setParamByTag(const std::string& tag, const std::string& value)
         if (v == CNS_SP_MT_CHEB)  { SearchParams[CN_SP_MT] = CN_SP_MT_CHEB;  return true; }
         return false;
     }
+    if (tag == CNS_TAG_HW || tag == CNS_TAG_DL || tag == CNS_TAG_EL || tag == CNS_TAG_TL ||
+            tag == CNS_TAG_LM) {
+        std::istringstream stream(v);
+        double number;
+        if (!(stream >> number) || !(stream >> std::ws).eof())
+            return false;
+        return setParamByTag(tag, number);
+    }
     if (tag == CNS_TAG_BT) {
         if (v == CNS_SP_BT_GMIN)  { SearchParams[CN_SP_BT] = CN_SP_BT_GMIN;  return true; }
         if (v == CNS_SP_BT_GMAX)  { SearchParams[CN_SP_BT] = CN_SP_BT_GMAX;  return true; }
         return false;
     }
-    if (tag == CNS_TAG_AD || tag == CNS_TAG_CC || tag == CNS_TAG_AS || tag == CNS_TAG_PS) {
+    if (tag == CNS_TAG_AD || tag == CNS_TAG_CC || tag == CNS_TAG_AS || tag == CNS_TAG_PS || tag == CNS_TAG_FP ||
+            tag == CNS_TAG_PAR || tag == CNS_TAG_DO || tag == CNS_TAG_GB) {
         if (v == "1" || v == "true") {
             if (tag == CNS_TAG_AD) SearchParams[CN_SP_AD] = 1;
             if (tag == CNS_TAG_CC) SearchParams[CN_SP_CC] = 1;
             if (tag == CNS_TAG_AS) SearchParams[CN_SP_AS] = 1;
             if (tag == CNS_TAG_PS) SearchParams[CN_SP_PS] = 1;
+            if (tag == CNS_TAG_FP) SearchParams[CN_SP_FP] = 1;
+            if (tag == CNS_TAG_PAR) SearchParams[CN_SP_PAR] = 1;
+            if (tag == CNS_TAG_DO) SearchParams[CN_SP_DO] = 1;
+            if (tag == CNS_TAG_GB) SearchParams[CN_SP_GB] = 1;
             return true;
         }
         if (v == "0" || v == "false") {
@@ -69,6 +110,10 @@ bool Config::setParamByTag(const std::string& tag, const std::string& value)
             if (tag == CNS_TAG_CC) SearchParams[CN_SP_CC] = 0;
             if (tag == CNS_TAG_AS) SearchParams[CN_SP_AS] = 0;
             if (tag == CNS_TAG_PS) SearchParams[CN_SP_PS] = 0;
+            if (tag == CNS_TAG_FP) SearchParams[CN_SP_FP] = 0;
+            if (tag == CNS_TAG_PAR) SearchParams[CN_SP_PAR] = 0;
+            if (tag == CNS_TAG_DO) SearchParams[CN_SP_DO] = 0;
+            if (tag == CNS_TAG_GB) SearchParams[CN_SP_GB] = 0;
             return true;
         }
         return false;
@@ -85,15 +130,33 @@ bool Config::setParamByTag(const std::string& tag, double value)
         SearchParams[CN_SP_HW] = value;
         return true;
     }
+    if (tag == CNS_TAG_DL) {
+        if (value < 0) value = 0;
+        SearchParams[CN_SP_DL] = value;
+        return true;
+    }
+    if (tag == CNS_TAG_EL) {
+        if (value < 0) value = 0;
+        SearchParams[CN_SP_EL] = floor(value);
+        return true;
+    }
+    if (tag == CNS_TAG_TL) {
+        if (value < 0) value = 0;
+        SearchParams[CN_SP_TL] = value;
+        return true;
+    }
+    if (tag == CNS_TAG_LM) {
+        if (value < 0) value = 0;
+        SearchParams[CN_SP_LM] = std::min(floor(value), static_cast<double>(CN_LM_MAX));
+        return true;
+    }
     return false;
 }
 
 // Set all parameters to default values (A* with Euclidean, all options off)
 void Config::setDefaultConfigAstar()
 {
-    if (SearchParams) delete[] SearchParams;
-    N = 8;
-    SearchParams = new double[N];
+    allocateParams();
     SearchParams[CN_SP_ST] = CN_SP_ST_ASTAR;
     SearchParams[CN_SP_HW] = 1;
     SearchParams[CN_SP_MT] = CN_SP_MT_EUCL;
@@ -102,13 +165,19 @@ void Config::setDefaultConfigAstar()
     SearchParams[CN_SP_CC] = 0;
     SearchParams[CN_SP_AS] = 0;
     SearchParams[CN_SP_PS] = 0;
+    SearchParams[CN_SP_FP] = 0;
+    SearchParams[CN_SP_PAR] = 0;
+    SearchParams[CN_SP_DL] = 0;
+    SearchParams[CN_SP_EL] = 0;
+    SearchParams[CN_SP_TL] = 0;
+    SearchParams[CN_SP_LM] = 0;
+    SearchParams[CN_SP_DO] = 0;
+    SearchParams[CN_SP_GB] = 0;
 }
 
 void Config::setDefaultConfigTheta()
 {
-    if (SearchParams) delete[] SearchParams;
-    N = 8;
-    SearchParams = new double[N];
+    allocateParams();
     SearchParams[CN_SP_ST] = CN_SP_ST_TH;
     SearchParams[CN_SP_HW] = 1;
     SearchParams[CN_SP_MT] = CN_SP_MT_EUCL; // Theta* requires Euclidean metric
@@ -117,6 +186,14 @@ void Config::setDefaultConfigTheta()
     SearchParams[CN_SP_CC] = 0;
     SearchParams[CN_SP_AS] = 0;
     SearchParams[CN_SP_PS] = 0;
+    SearchParams[CN_SP_FP] = 0;
+    SearchParams[CN_SP_PAR] = 0;
+    SearchParams[CN_SP_DL] = 0;
+    SearchParams[CN_SP_EL] = 0;
+    SearchParams[CN_SP_TL] = 0;
+    SearchParams[CN_SP_LM] = 0;
+    SearchParams[CN_SP_DO] = 0;
+    SearchParams[CN_SP_GB] = 0;
 }
 
 
@@ -153,12 +230,40 @@ bool Config::getConfig(const char *FileName)
         value = element->GetText();
     std::transform(value.begin(), value.end(), value.begin(), ::tolower);
 
-    if (value == CNS_SP_ST_ASTAR || value == CNS_SP_ST_TH) {
-        N = 8;
-        SearchParams = new double[N];
+    if (value == CNS_SP_ST_ASTAR || value == CNS_SP_ST_TH || value == CNS_SP_ST_JPS || value == CNS_SP_ST_JPSPLUS ||
+            value == CNS_SP_ST_BASTAR || value == CNS_SP_ST_BDIJKSTRA || value == CNS_SP_ST_HPASTAR ||
+            value == CNS_SP_ST_HPATHETA || value == CNS_SP_ST_LTH || value == CNS_SP_ST_DSL || value == CNS_SP_ST_ARA ||
+            value == CNS_SP_ST_CPD || value == CNS_SP_ST_CH || value == CNS_SP_ST_HL || value == CNS_SP_ST_SUB) {
+        allocateParams();
         SearchParams[CN_SP_ST] = CN_SP_ST_ASTAR;
         if (value == CNS_SP_ST_TH)
             SearchParams[CN_SP_ST] = CN_SP_ST_TH;
+        else if (value == CNS_SP_ST_JPS)
+            SearchParams[CN_SP_ST] = CN_SP_ST_JPS;
+        else if (value == CNS_SP_ST_JPSPLUS)
+            SearchParams[CN_SP_ST] = CN_SP_ST_JPSPLUS;
+        else if (value == CNS_SP_ST_BASTAR)
+            SearchParams[CN_SP_ST] = CN_SP_ST_BASTAR;
+        else if (value == CNS_SP_ST_BDIJKSTRA)
+            SearchParams[CN_SP_ST] = CN_SP_ST_BDIJKSTRA;
+        else if (value == CNS_SP_ST_HPASTAR)
+            SearchParams[CN_SP_ST] = CN_SP_ST_HPASTAR;
+        else if (value == CNS_SP_ST_HPATHETA)
+            SearchParams[CN_SP_ST] = CN_SP_ST_HPATHETA;
+        else if (value == CNS_SP_ST_LTH)
+            SearchParams[CN_SP_ST] = CN_SP_ST_LTH;
+        else if (value == CNS_SP_ST_DSL)
+            SearchParams[CN_SP_ST] = CN_SP_ST_DSL;
+        else if (value == CNS_SP_ST_ARA)
+            SearchParams[CN_SP_ST] = CN_SP_ST_ARA;
+        else if (value == CNS_SP_ST_CPD)
+            SearchParams[CN_SP_ST] = CN_SP_ST_CPD;
+        else if (value == CNS_SP_ST_CH)
+            SearchParams[CN_SP_ST] = CN_SP_ST_CH;
+        else if (value == CNS_SP_ST_HL)
+            SearchParams[CN_SP_ST] = CN_SP_ST_HL;
+        else if (value == CNS_SP_ST_SUB)
+            SearchParams[CN_SP_ST] = CN_SP_ST_SUB;
         element = algorithm->FirstChildElement(CNS_TAG_HW);
         if (!element) {
             std::cout << "Warning! No '" << CNS_TAG_HW << "' tag found in algorithm section." << std::endl;
@@ -198,7 +303,8 @@ bool Config::getConfig(const char *FileName)
                 std::cout << "Value of '" << CNS_TAG_MT << "' was defined to 'euclidean'" << std::endl;
                 SearchParams[CN_SP_MT] = CN_SP_MT_EUCL;
             }
-            if (SearchParams[CN_SP_ST] == CN_SP_ST_TH && SearchParams[CN_SP_MT] != CN_SP_MT_EUCL) {
+            if ((SearchParams[CN_SP_ST] == CN_SP_ST_TH || SearchParams[CN_SP_ST] == CN_SP_ST_LTH) &&
+                    SearchParams[CN_SP_MT] != CN_SP_MT_EUCL) {
                 std::cout << "Warning! This type of metric is not admissible for Theta*!" << std::endl;
             }
         }
@@ -226,7 +332,11 @@ bool Config::getConfig(const char *FileName)
         std::cout << "Error! Value of '" << CNS_TAG_ST << "' tag (algorithm name) is not correctly specified."
                   << std::endl;
         std::cout << "Supported algorithm's names are: '"  <<
-                  CNS_SP_ST_ASTAR << "', '" << CNS_SP_ST_TH << "'." << std::endl;
+                  CNS_SP_ST_ASTAR << "', '" << CNS_SP_ST_TH << "', '" << CNS_SP_ST_JPS << "', '" << CNS_SP_ST_JPSPLUS << "', '" <<
+                  CNS_SP_ST_BASTAR << "', '" << CNS_SP_ST_BDIJKSTRA << "', '" << CNS_SP_ST_HPASTAR << "', '" <<
+                  CNS_SP_ST_HPATHETA << "', '" << CNS_SP_ST_LTH << "', '" << CNS_SP_ST_DSL << "', '" <<
+                  CNS_SP_ST_ARA << "', '" << CNS_SP_ST_CPD << "', '" << CNS_SP_ST_CH << "', '" << CNS_SP_ST_HL << "', '" <<
+                  CNS_SP_ST_SUB << "'." << std::endl;
         return false;
     }
 
@@ -325,7 +435,7 @@ bool Config::getConfig(const char *FileName)
     else
     {
         SearchParams[CN_SP_PS] = 0;
-        if(SearchParams[CN_SP_ST] != CN_SP_ST_TH)
+        if(SearchParams[CN_SP_ST] != CN_SP_ST_TH && SearchParams[CN_SP_ST] != CN_SP_ST_LTH)
         {
             std::string check;
             stream << element->GetText();
@@ -345,5 +455,142 @@ bool Config::getConfig(const char *FileName)
         }
     }
 
+    //Optional, older configurations do not have it
+    SearchParams[CN_SP_FP] = 0;
+    element = algorithm->FirstChildElement(CNS_TAG_FP);
+    if (element && SearchParams[CN_SP_ST] == CN_SP_ST_ASTAR) {
+        std::string check;
+        stream << element->GetText();
+        stream >> check;
+        stream.clear();
+        stream.str("");
+        if (check != "1" && check != "true" && check != "0" && check != "false") {
+            std::cout << "Warning! Value of '" << CNS_TAG_FP << "' is not correctly specified." << std::endl;
+            std::cout << "Value of '" << CNS_TAG_FP << "' was defined to default - false " << std::endl;
+        }
+        else if (check == "1" || check == "true")
+            SearchParams[CN_SP_FP] = 1;
+    }
+
+    SearchParams[CN_SP_PAR] = 0;
+    element = algorithm->FirstChildElement(CNS_TAG_PAR);
+    if (element && (SearchParams[CN_SP_ST] == CN_SP_ST_BASTAR || SearchParams[CN_SP_ST] == CN_SP_ST_BDIJKSTRA)) {
+        std::string check;
+        stream << element->GetText();
+        stream >> check;
+        stream.clear();
+        stream.str("");
+        if (check != "1" && check != "true" && check != "0" && check != "false") {
+            std::cout << "Warning! Value of '" << CNS_TAG_PAR << "' is not correctly specified." << std::endl;
+            std::cout << "Value of '" << CNS_TAG_PAR << "' was defined to default - false " << std::endl;
+        }
+        else if (check == "1" || check == "true")
+            SearchParams[CN_SP_PAR] = 1;
+    }
+
+    SearchParams[CN_SP_DL] = 0;
+    element = algorithm->FirstChildElement(CNS_TAG_DL);
+    if (element && SearchParams[CN_SP_ST] == CN_SP_ST_ARA) {
+        double deadline = -1;
+        stream << element->GetText();
+        stream >> deadline;
+        stream.clear();
+        stream.str("");
+        if (deadline < 0) {
+            std::cout << "Warning! Value of '" << CNS_TAG_DL << "' is not correctly specified. Should be >= 0." << std::endl;
+            std::cout << "Value of '" << CNS_TAG_DL << "' was defined to default - 0 (no deadline)" << std::endl;
+        }
+        else
+            SearchParams[CN_SP_DL] = deadline;
+    }
+
+    SearchParams[CN_SP_EL] = 0;
+    element = algorithm->FirstChildElement(CNS_TAG_EL);
+    if (element) {
+        double limit = -1;
+        stream << element->GetText();
+        stream >> limit;
+        stream.clear();
+        stream.str("");
+        if (limit < 0) {
+            std::cout << "Warning! Value of '" << CNS_TAG_EL << "' is not correctly specified. Should be >= 0." << std::endl;
+            std::cout << "Value of '" << CNS_TAG_EL << "' was defined to default - 0 (no limit)" << std::endl;
+        }
+        else
+            SearchParams[CN_SP_EL] = floor(limit);
+    }
+
+    SearchParams[CN_SP_TL] = 0;
+    element = algorithm->FirstChildElement(CNS_TAG_TL);
+    if (element) {
+        double limit = -1;
+        stream << element->GetText();
+        stream >> limit;
+        stream.clear();
+        stream.str("");
+        if (limit < 0) {
+            std::cout << "Warning! Value of '" << CNS_TAG_TL << "' is not correctly specified. Should be >= 0." << std::endl;
+            std::cout << "Value of '" << CNS_TAG_TL << "' was defined to default - 0 (no limit)" << std::endl;
+        }
+        else
+            SearchParams[CN_SP_TL] = limit;
+    }
+    if (SearchParams[CN_SP_ST] == CN_SP_ST_DSL && (SearchParams[CN_SP_EL] || SearchParams[CN_SP_TL])) {
+        std::cout << "Warning! '" << CNS_TAG_EL << "' and '" << CNS_TAG_TL << "' are not supported by D* Lite." << std::endl;
+        std::cout << "Values of '" << CNS_TAG_EL << "' and '" << CNS_TAG_TL << "' were defined to default - 0 (no limit)"
+                  << std::endl;
+        SearchParams[CN_SP_EL] = 0;
+        SearchParams[CN_SP_TL] = 0;
+    }
+
+    SearchParams[CN_SP_LM] = 0;
+    element = algorithm->FirstChildElement(CNS_TAG_LM);
+    if (element) {
+        double landmarks = -1;
+        stream << element->GetText();
+        stream >> landmarks;
+        stream.clear();
+        stream.str("");
+        if (landmarks < 0) {
+            std::cout << "Warning! Value of '" << CNS_TAG_LM << "' is not correctly specified. Should be >= 0." << std::endl;
+            std::cout << "Value of '" << CNS_TAG_LM << "' was defined to default - 0 (no landmarks)" << std::endl;
+        }
+        else
+            SearchParams[CN_SP_LM] = std::min(floor(landmarks), static_cast<double>(CN_LM_MAX));
+    }
+
+    SearchParams[CN_SP_DO] = 0;
+    element = algorithm->FirstChildElement(CNS_TAG_DO);
+    if (element) {
+        std::string check;
+        stream << element->GetText();
+        stream >> check;
+        stream.clear();
+        stream.str("");
+        if (check != "1" && check != "true" && check != "0" && check != "false") {
+            std::cout << "Warning! Value of '" << CNS_TAG_DO << "' is not correctly specified." << std::endl;
+            std::cout << "Value of '" << CNS_TAG_DO << "' was defined to default - false " << std::endl;
+        }
+        else if (check == "1" || check == "true")
+            SearchParams[CN_SP_DO] = 1;
+    }
+
+    SearchParams[CN_SP_GB] = 0;
+    element = algorithm->FirstChildElement(CNS_TAG_GB);
+    if (element && (SearchParams[CN_SP_ST] == CN_SP_ST_ASTAR || SearchParams[CN_SP_ST] == CN_SP_ST_JPS ||
+                    SearchParams[CN_SP_ST] == CN_SP_ST_JPSPLUS)) {
+        std::string check;
+        stream << element->GetText();
+        stream >> check;
+        stream.clear();
+        stream.str("");
+        if (check != "1" && check != "true" && check != "0" && check != "false") {
+            std::cout << "Warning! Value of '" << CNS_TAG_GB << "' is not correctly specified." << std::endl;
+            std::cout << "Value of '" << CNS_TAG_GB << "' was defined to default - false " << std::endl;
+        }
+        else if (check == "1" || check == "true")
+            SearchParams[CN_SP_GB] = 1;
+    }
+
     return true;
 }
@@ -0,0 +1,495 @@
+#include "contraction.h"
+#include "searchkernel.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <utility>
+
+#define CN_CH_EPS 1e-7 //path lengths closer than this are equal (distinct sums of 1 and sqrt(2) differ by far more)
+
+typedef ContractionHierarchy::Arc Arc;
+
+static const int chMoves[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+
+ContractionHierarchy::ContractionHierarchy()
+{
+    height = 0;
+    width = 0;
+    movement = CN_MR_NOCORNER;
+    buildTime = 0;
+}
+
+bool ContractionHierarchy::fits(const Map &map, const EnvironmentOptions &options) const
+{
+    return movement == options.movementRules() && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t ContractionHierarchy::memoryUsage() const
+{
+    return (node.size() + cells.size()) * sizeof(int32_t) + first.size() * sizeof(uint32_t) + arcs.size() * sizeof(Arc);
+}
+
+void ContractionHierarchy::numberCells()
+{
+    node.assign(static_cast<std::size_t>(height) * width, -1);
+    cells.clear();
+    for (int i = 0; i < height; i++)
+        for (int j = 0; j < width; j++)
+            if (!grid->isObstacle(i, j)) {
+                node[static_cast<std::size_t>(i) * width + j] = static_cast<int32_t>(cells.size());
+                cells.push_back(i * width + j);
+            }
+}
+
+const Arc* ContractionHierarchy::findArc(int from, int to) const
+{
+    const Arc *begin = arcs.data() + first[from], *end = arcs.data() + first[from + 1];
+    const Arc *arc = std::lower_bound(begin, end, to, [](const Arc &a, int head) {return a.head < head;});
+    return (arc != end && arc->head == to) ? arc : nullptr;
+}
+
+bool ContractionHierarchy::unpack(int from, int to, int middle, std::vector<int> &path) const
+{
+    if (middle < 0) {
+        path.push_back(to);
+        return true;
+    }
+    //Both halves are upward arcs of the skipped node, which was contracted before the ends of the shortcut
+    const Arc *down = findArc(middle, from), *up = findArc(middle, to);
+    return down && up && unpack(from, middle, down->middle, path) && unpack(middle, to, up->middle, path);
+}
+
+//Arcs of every node to its neighbouring cells
+template <int Movement>
+static void linkNodes(const Map &map, const ContractionHierarchy &hierarchy, std::vector<std::vector<Arc>> &graph)
+{
+    static const double diagonalCost = sqrt(2);
+    graph.assign(hierarchy.cells.size(), std::vector<Arc>());
+    for (std::size_t v = 0; v < hierarchy.cells.size(); v++) {
+        int i = hierarchy.cells[v] / map.width, j = hierarchy.cells[v] % map.width;
+        for (int k = 0; k < 8; k++) {
+            int di = chMoves[k][0], dj = chMoves[k][1];
+            bool diagonal = (di != 0 && dj != 0);
+            if ((Movement == CN_MR_CARDINAL && diagonal) || !map.CellIsTraversable(i + di, j + dj) ||
+                    (diagonal && !diagonalMoveAllowed<Movement>(map, i, j, di, dj)))
+                continue;
+            Arc arc = {hierarchy.node[hierarchy.cells[v] + di * map.width + dj], -1, diagonal ? diagonalCost : 1};
+            graph[v].push_back(arc);
+        }
+    }
+}
+
+struct Shortcut
+{
+    int     from, to, middle;
+    double  cost;
+};
+
+//Per-worker buffers of the witness searches
+struct WitnessBuffers
+{
+    std::vector<double>                 dist;
+    std::vector<int>                    touched;
+    std::vector<std::pair<double, int>> queue;
+    std::vector<char>                   target;
+    std::vector<Shortcut>               shortcuts;
+};
+
+//Dijkstra search from 'source' in the remaining graph that avoids 'avoid' and the nodes marked in 'skip'. It stops
+//when the 'targets' nodes marked in buffers.target are settled, beyond distance 'limit' or after CN_CH_SETTLED
+//settled nodes, and leaves the distances found in buffers.dist
+static void witnessSearch(const std::vector<std::vector<Arc>> &graph, const std::vector<char> &skip, int avoid,
+                          int source, int targets, double limit, WitnessBuffers &buffers)
+{
+    typedef std::pair<double, int> Entry;
+    std::vector<double> &dist = buffers.dist;
+    std::vector<Entry> &queue = buffers.queue;
+    for (std::size_t k = 0; k < buffers.touched.size(); k++)
+        dist[buffers.touched[k]] = std::numeric_limits<double>::infinity();
+    buffers.touched.assign(1, source);
+    queue.assign(1, Entry(0, source));
+    dist[source] = 0;
+    for (int settled = 0; !queue.empty() && settled < CN_CH_SETTLED; ) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<Entry>());
+        Entry entry = queue.back();
+        queue.pop_back();
+        if (entry.first > dist[entry.second])
+            continue;
+        if (entry.first > limit)
+            break;
+        if (buffers.target[entry.second] && --targets == 0)
+            break;
+        settled++;
+        const std::vector<Arc> &arcs = graph[entry.second];
+        for (std::size_t a = 0; a < arcs.size(); a++) {
+            int head = arcs[a].head;
+            double d = entry.first + arcs[a].cost;
+            if (head == avoid || skip[head] || d >= dist[head])
+                continue;
+            if (dist[head] == std::numeric_limits<double>::infinity())
+                buffers.touched.push_back(head);
+            dist[head] = d;
+            queue.push_back(Entry(d, head));
+            std::push_heap(queue.begin(), queue.end(), std::greater<Entry>());
+        }
+    }
+}
+
+//Shortcuts that contracting v needs: pairs of its neighbours with no path as short as the one through v
+//that the witness search finds without v
+static void findShortcuts(const std::vector<std::vector<Arc>> &graph, const std::vector<char> &skip, int v,
+                          WitnessBuffers &buffers)
+{
+    buffers.shortcuts.clear();
+    const std::vector<Arc> &arcs = graph[v];
+    for (std::size_t a = 0; a + 1 < arcs.size(); a++) {
+        double longest = 0;
+        for (std::size_t c = a + 1; c < arcs.size(); c++) {
+            longest = std::max(longest, arcs[c].cost);
+            buffers.target[arcs[c].head] = 1;
+        }
+        witnessSearch(graph, skip, v, arcs[a].head, static_cast<int>(arcs.size() - a - 1), arcs[a].cost + longest, buffers);
+        for (std::size_t c = a + 1; c < arcs.size(); c++) {
+            double cost = arcs[a].cost + arcs[c].cost;
+            if (buffers.dist[arcs[c].head] > cost + CN_CH_EPS) {
+                Shortcut shortcut = {arcs[a].head, arcs[c].head, v, cost};
+                buffers.shortcuts.push_back(shortcut);
+            }
+            buffers.target[arcs[c].head] = 0;
+        }
+    }
+}
+
+//Adds an arc or lowers the cost of the one with the same head
+static void addArc(std::vector<Arc> &arcs, int head, int middle, double cost)
+{
+    for (std::size_t a = 0; a < arcs.size(); a++)
+        if (arcs[a].head == head) {
+            if (cost < arcs[a].cost - CN_CH_EPS) {
+                arcs[a].middle = middle;
+                arcs[a].cost = cost;
+            }
+            return;
+        }
+    Arc arc = {head, middle, cost};
+    arcs.push_back(arc);
+}
+
+std::shared_ptr<const ContractionHierarchy> ContractionHierarchy::build(const Map &map, const EnvironmentOptions &options,
+                                                                        int threads)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<ContractionHierarchy> result = std::make_shared<ContractionHierarchy>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = options.movementRules();
+    result->grid = map.getSharedGrid();
+    result->numberCells();
+
+    std::vector<std::vector<Arc>> graph;
+    switch (result->movement) {
+        case CN_MR_CARDINAL:
+            linkNodes<CN_MR_CARDINAL>(map, *result, graph);
+            break;
+        case CN_MR_NOCORNER:
+            linkNodes<CN_MR_NOCORNER>(map, *result, graph);
+            break;
+        case CN_MR_CORNER:
+            linkNodes<CN_MR_CORNER>(map, *result, graph);
+            break;
+        default:
+            linkNodes<CN_MR_SQUEEZE>(map, *result, graph);
+    }
+
+    int n = result->nodes();
+    std::vector<std::vector<Arc>> upward(n);
+    std::vector<int> priority(n), contractedNeighbours(n, 0), remaining(n), update(n);
+    std::vector<char> skip(n, 0);//contracted, or contracted in the current round
+    for (int v = 0; v < n; v++)
+        remaining[v] = update[v] = v;
+    ThreadPool pool(threads);
+    std::vector<WitnessBuffers> buffers(pool.size());
+    for (int k = 0; k < pool.size(); k++) {
+        buffers[k].dist.assign(n, std::numeric_limits<double>::infinity());
+        buffers[k].target.assign(n, 0);
+    }
+    //A node comes first if it adds few shortcuts for the arcs it removes and few of its neighbours are gone,
+    //which spreads the contraction evenly over the map
+    std::function<void(int, int)> prioritize = [&](int worker, int k) {
+        int v = update[k];
+        findShortcuts(graph, skip, v, buffers[worker]);
+        priority[v] = 2 * static_cast<int>(buffers[worker].shortcuts.size()) - static_cast<int>(graph[v].size()) +
+                      contractedNeighbours[v];
+    };
+    //Equal priorities are ordered by a hash of the node, so nodes that come before all their neighbours are
+    //scattered over the map instead of following the row order
+    auto before = [&](int a, int b) {
+        uint32_t ha = static_cast<uint32_t>(a) * 2654435761u, hb = static_cast<uint32_t>(b) * 2654435761u;
+        return priority[a] < priority[b] || (priority[a] == priority[b] && (ha < hb || (ha == hb && a < b)));
+    };
+    pool.run(n, prioritize);
+
+    std::vector<int> selected;
+    std::vector<std::vector<Shortcut>> shortcuts;
+    while (!remaining.empty()) {
+        //The nodes that come before all their neighbours are independent and are contracted in this round
+        selected.clear();
+        for (std::size_t k = 0; k < remaining.size(); k++) {
+            int v = remaining[k];
+            bool local = true;
+            for (std::size_t a = 0; a < graph[v].size() && local; a++)
+                local = before(v, graph[v][a].head);
+            if (local)
+                selected.push_back(v);
+        }
+        for (std::size_t k = 0; k < selected.size(); k++)
+            skip[selected[k]] = 1;
+        //A witness path must not lead through another node of the round, whose own shortcuts do not know about it
+        shortcuts.resize(selected.size());
+        pool.run(static_cast<int>(selected.size()), [&](int worker, int k) {
+            findShortcuts(graph, skip, selected[k], buffers[worker]);
+            shortcuts[k].swap(buffers[worker].shortcuts);
+        });
+
+        update.clear();
+        for (std::size_t k = 0; k < selected.size(); k++) {
+            int v = selected[k];
+            upward[v].swap(graph[v]);
+            for (std::size_t a = 0; a < upward[v].size(); a++) {
+                std::vector<Arc> &arcs = graph[upward[v][a].head];
+                for (std::size_t b = 0; b < arcs.size(); b++)
+                    if (arcs[b].head == v) {
+                        arcs[b] = arcs.back();
+                        arcs.pop_back();
+                        break;
+                    }
+                contractedNeighbours[upward[v][a].head]++;
+                update.push_back(upward[v][a].head);
+            }
+            for (std::size_t s = 0; s < shortcuts[k].size(); s++) {
+                const Shortcut &shortcut = shortcuts[k][s];
+                addArc(graph[shortcut.from], shortcut.to, v, shortcut.cost);
+                addArc(graph[shortcut.to], shortcut.from, v, shortcut.cost);
+            }
+            std::vector<Arc>().swap(graph[v]);
+        }
+        remaining.erase(std::remove_if(remaining.begin(), remaining.end(), [&](int v) {return skip[v] != 0;}),
+                        remaining.end());
+        std::sort(update.begin(), update.end());
+        update.erase(std::unique(update.begin(), update.end()), update.end());
+        pool.run(static_cast<int>(update.size()), prioritize);
+    }
+
+    result->first.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        std::sort(upward[v].begin(), upward[v].end(), [](const Arc &a, const Arc &b) {return a.head < b.head;});
+        result->first[v + 1] = result->first[v] + static_cast<uint32_t>(upward[v].size());
+    }
+    result->arcs.reserve(result->first[n]);
+    for (int v = 0; v < n; v++) {
+        result->arcs.insert(result->arcs.end(), upward[v].begin(), upward[v].end());
+        std::vector<Arc>().swap(upward[v]);
+    }
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+static const char chMagic[4] = {'C', 'H', 'G', 'R'};
+
+bool ContractionHierarchy::save(const std::string &fileName) const
+{
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    int32_t header[4] = {CN_CH_VERSION, height, width, movement};
+    uint64_t sizes[3] = {grid->fingerprint(), cells.size(), arcs.size()};
+    file.write(chMagic, sizeof(chMagic));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+    //The nodes follow from the grid, so only the arcs are written
+    file.write(reinterpret_cast<const char *>(first.data()), first.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char *>(arcs.data()), arcs.size() * sizeof(Arc));
+    file.close();
+    return !file.fail();
+}
+
+std::shared_ptr<const ContractionHierarchy> ContractionHierarchy::load(const std::string &fileName, const Map &map)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    char magic[4];
+    int32_t header[4];
+    uint64_t sizes[3];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    file.read(reinterpret_cast<char *>(sizes), sizeof(sizes));
+    if (!file || memcmp(magic, chMagic, sizeof(magic)) != 0 || header[0] != CN_CH_VERSION ||
+            header[1] != map.height || header[2] != map.width || header[3] < 0 || header[3] >= CN_MR_COUNT ||
+            sizes[0] != map.getGrid().fingerprint())
+        return nullptr;
+
+    std::shared_ptr<ContractionHierarchy> result = std::make_shared<ContractionHierarchy>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = header[3];
+    result->grid = map.getSharedGrid();
+    result->numberCells();
+    if (sizes[1] != result->cells.size() || sizes[2] >= (uint64_t(1) << 32))
+        return nullptr;
+    result->first.resize(result->cells.size() + 1);
+    result->arcs.resize(sizes[2]);
+    file.read(reinterpret_cast<char *>(result->first.data()), result->first.size() * sizeof(uint32_t));
+    file.read(reinterpret_cast<char *>(result->arcs.data()), result->arcs.size() * sizeof(Arc));
+    if (!file || result->first[0] != 0 || result->first.back() != result->arcs.size())
+        return nullptr;
+    int n = result->nodes();
+    for (int v = 0; v < n; v++) {
+        if (result->first[v] > result->first[v + 1])
+            return nullptr;
+        for (uint32_t a = result->first[v]; a < result->first[v + 1]; a++) {
+            const Arc &arc = result->arcs[a];
+            if (arc.head < 0 || arc.head >= n || arc.head == v || arc.middle < -1 || arc.middle >= n || !(arc.cost > 0))
+                return nullptr;
+        }
+    }
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+CHSearch::CHSearch(std::shared_ptr<const ContractionHierarchy> hierarchy):Astar(1, CN_SP_BT_GMAX)
+{
+    this->hierarchy = hierarchy;
+}
+
+SearchResult CHSearch::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    if (!hierarchy || !hierarchy->fits(map, options)) {
+        hierarchy = ContractionHierarchy::build(map, options);
+        sresult.preprocessingtime = hierarchy->buildTime;
+    }
+    sresult.preprocessingmemory = hierarchy->memoryUsage();
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::size_t n = hierarchy->cells.size();
+    for (int d = 0; d < 2; d++)
+        if (dist[d].size() != n) {
+            dist[d].assign(n, infinity);
+            parentArc[d].resize(n);
+            parent[d].resize(n);
+        }
+    int ends[2] = {hierarchy->node[map.start_i * map.width + map.start_j], hierarchy->node[map.goal_i * map.width + map.goal_j]};
+    double best = infinity;
+    int meet = -1;
+    touched.clear();
+    if (ends[0] >= 0 && ends[1] >= 0) {
+        for (int d = 0; d < 2; d++) {
+            dist[d][ends[d]] = 0;
+            queue[d].assign(1, Entry(0, ends[d]));
+            touched.push_back(ends[d]);
+        }
+    }
+    //The directions take turns by the smaller distance and stop once it reaches the best path through a node
+    //both have settled: every node of the path left is above the top of the path in the hierarchy
+    while (true) {
+        int d = -1;
+        for (int k = 0; k < 2; k++)
+            if (!queue[k].empty() && queue[k].front().first < best &&
+                    (d < 0 || queue[k].front().first < queue[d].front().first))
+                d = k;
+        if (d < 0)
+            break;
+        std::pop_heap(queue[d].begin(), queue[d].end(), std::greater<Entry>());
+        Entry entry = queue[d].back();
+        queue[d].pop_back();
+        int v = entry.second;
+        if (entry.first > dist[d][v])
+            continue;
+        sresult.numberofsteps++;
+        if (entry.first + dist[1 - d][v] < best) {
+            best = entry.first + dist[1 - d][v];
+            meet = v;
+        }
+        //Stall-on-demand: the arcs of a node are also the ways down to it, and if one of them reaches it on a
+        //shorter path, the upward search from this node cannot be on a shortest path
+        bool stalled = false;
+        for (uint32_t a = hierarchy->first[v]; a < hierarchy->first[v + 1] && !stalled; a++)
+            stalled = (dist[d][hierarchy->arcs[a].head] + hierarchy->arcs[a].cost < entry.first - CN_CH_EPS);
+        if (stalled)
+            continue;
+        for (uint32_t a = hierarchy->first[v]; a < hierarchy->first[v + 1]; a++) {
+            const ContractionHierarchy::Arc &arc = hierarchy->arcs[a];
+            double g = entry.first + arc.cost;
+            if (g >= dist[d][arc.head])
+                continue;
+            if (dist[1 - d][arc.head] == infinity && dist[d][arc.head] == infinity)
+                touched.push_back(arc.head);
+            dist[d][arc.head] = g;
+            parentArc[d][arc.head] = static_cast<int>(a);
+            parent[d][arc.head] = v;
+            queue[d].push_back(Entry(g, arc.head));
+            std::push_heap(queue[d].begin(), queue[d].end(), std::greater<Entry>());
+        }
+    }
+
+    //Nodes from the start up to the meeting node and down to the goal, every arc unpacked into moves
+    std::vector<int> nodes;
+    bool pathfound = (meet >= 0);
+    if (pathfound && !distanceonly) {
+        std::vector<int> up(1, meet);
+        while (up.back() != ends[0])
+            up.push_back(parent[0][up.back()]);
+        nodes.push_back(ends[0]);
+        for (std::size_t k = up.size() - 1; k > 0 && pathfound; k--)
+            pathfound = hierarchy->unpack(up[k], up[k - 1], hierarchy->arcs[parentArc[0][up[k - 1]]].middle, nodes);
+        for (int v = meet; v != ends[1] && pathfound; v = parent[1][v])
+            pathfound = hierarchy->unpack(v, parent[1][v], hierarchy->arcs[parentArc[1][v]].middle, nodes);
+    }
+    sresult.nodescreated = static_cast<unsigned int>(touched.size());
+    for (std::size_t k = 0; k < touched.size(); k++)
+        dist[0][touched[k]] = dist[1][touched[k]] = infinity;
+    queue[0].clear();
+    queue[1].clear();
+
+    if (pathfound && distanceonly) {
+        sresult.pathfound = true;
+        sresult.pathlength = best;
+    }
+    else if (pathfound) {
+        Node curNode;
+        curNode.g = 0;
+        curNode.H = 0;
+        curNode.parent = -1;
+        for (std::size_t k = 0; k < nodes.size(); k++) {
+            int cell = hierarchy->cells[nodes[k]], i = cell / map.width, j = cell % map.width;
+            if (k > 0) {
+                curNode.parent = curNode.i * map.width + curNode.j;
+                curNode.g += (i != curNode.i && j != curNode.j) ? sqrt(2) : 1;
+            }
+            curNode.i = i;
+            curNode.j = j;
+            curNode.F = curNode.g;
+            lppath.push_back(curNode);
+        }
+        sresult.pathfound = true;
+        sresult.pathlength = curNode.g;
+    }
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
+    sresult.time -= sresult.preprocessingtime;
+    if (pathfound && !distanceonly)
+        makeSecondaryPath();
+
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
@@ -0,0 +1,307 @@
+#include "dstarlite.h"
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+
+static const double CN_DSL_INF = std::numeric_limits<double>::infinity();
+
+//km sums many heuristic values, so keys that are equal in theory may differ in the last bits. Ties of the first
+//component must still be broken by the second one, otherwise cells on a shortest path can stay inconsistent
+static bool keyLess(const std::pair<double, double> &a, const std::pair<double, double> &b)
+{
+    if (std::fabs(a.first - b.first) > 1e-9 * (1 + std::fabs(b.first)))
+        return a.first < b.first;
+    return a.second < b.second;
+}
+
+DStarLite::DStarLite() : Astar(1, CN_SP_BT_GMAX)
+{
+    height = 0;
+    width = 0;
+    movement = CN_MR_NOCORNER;
+    start = goal = last = 0;
+    km = 0;
+    queued = 0;
+    expansions = 0;
+}
+
+void DStarLite::reset(const Map &map, const EnvironmentOptions &options)
+{
+    grid = map.getGrid();
+    height = map.height;
+    width = map.width;
+    movement = options.movementRules();
+    start = map.start_i * width + map.start_j;
+    goal = map.goal_i * width + map.goal_j;
+    restart();
+}
+
+void DStarLite::restart()
+{
+    last = start;
+    km = 0;
+    Cell cell;
+    cell.g = cell.rhs = CN_DSL_INF;
+    cell.queued = false;
+    state.assign(static_cast<std::size_t>(height) * width, cell);
+    queue.clear();
+    queued = 0;
+    state[goal].rhs = 0;
+    updateVertex(goal);
+}
+
+bool DStarLite::setStart(int i, int j)
+{
+    if (i < 0 || i >= height || j < 0 || j >= width)
+        return false;
+    //Keys already in OPEN were computed for the old start, km keeps them lower bounds of the new ones
+    start = i * width + j;
+    km += heuristic(last);
+    last = start;
+    return true;
+}
+
+bool DStarLite::setGoal(int i, int j)
+{
+    if (i < 0 || i >= height || j < 0 || j >= width)
+        return false;
+    goal = i * width + j;
+    restart();
+    return true;
+}
+
+void DStarLite::setCell(int i, int j, bool obstacle)
+{
+    if (i < 0 || i >= height || j < 0 || j >= width || grid.isObstacle(i, j) == obstacle)
+        return;
+    grid.setObstacle(i, j, obstacle);
+    //Every move whose cost changes (including the diagonal ones whose corner is the cell) ends next to it
+    for (int di = -1; di <= 1; di++)
+        for (int dj = -1; dj <= 1; dj++) {
+            int ni = i + di, nj = j + dj;
+            if (ni < 0 || ni >= height || nj < 0 || nj >= width)
+                continue;
+            int id = ni * width + nj, next;
+            if (id != goal)
+                state[id].rhs = bestSuccessor(id, next);
+            updateVertex(id);
+        }
+}
+
+double DStarLite::heuristic(int id) const
+{
+    int di = std::abs(id / width - start / width), dj = std::abs(id % width - start % width);
+    if (movement == CN_MR_CARDINAL)
+        return di + dj;
+    return std::abs(di - dj) + CN_SQRT_TWO * std::min(di, dj);
+}
+
+template <class Visit>
+void DStarLite::forNeighbours(int id, Visit visit) const
+{
+    int i = id / width, j = id % width;
+    if (grid.isObstacle(i, j))
+        return;
+    for (int di = -1; di <= 1; di++)
+        for (int dj = -1; dj <= 1; dj++) {
+            if ((di == 0 && dj == 0) || grid.isObstacle(i + di, j + dj))
+                continue;
+            bool diagonal = (di != 0 && dj != 0);
+            if (diagonal) {
+                bool first = !grid.isObstacle(i, j + dj), second = !grid.isObstacle(i + di, j);
+                if (movement == CN_MR_CARDINAL || (movement == CN_MR_NOCORNER && !(first && second)) ||
+                        (movement == CN_MR_CORNER && !(first || second)))
+                    continue;
+            }
+            visit(id + di * width + dj, diagonal ? CN_SQRT_TWO : 1.0);
+        }
+}
+
+DStarLite::Key DStarLite::calculateKey(int id) const
+{
+    double value = std::min(state[id].g, state[id].rhs);
+    return Key(value + heuristic(id) + km, value);
+}
+
+void DStarLite::updateVertex(int id)
+{
+    Cell &cell = state[id];
+    if (cell.g != cell.rhs) {
+        Key key = calculateKey(id);
+        if (!cell.queued || key != cell.key) {
+            Entry entry = {key, id};
+            queue.push_back(entry);
+            std::push_heap(queue.begin(), queue.end());
+        }
+        if (!cell.queued)
+            queued++;
+        cell.key = key;
+        cell.queued = true;
+    }
+    else if (cell.queued) {
+        cell.queued = false;
+        queued--;
+    }
+}
+
+double DStarLite::bestSuccessor(int id, int &next) const
+{
+    double best = CN_DSL_INF;
+    next = -1;
+    forNeighbours(id, [&](int neighbour, double cost) {
+        if (cost + state[neighbour].g < best) {
+            best = cost + state[neighbour].g;
+            next = neighbour;
+        }
+    });
+    return best;
+}
+
+void DStarLite::compactQueue()
+{
+    if (queue.size() < 2 * queued + 1024)
+        return;
+    std::vector<Entry>::iterator end = std::remove_if(queue.begin(), queue.end(), [this](const Entry &entry) {
+        return !state[entry.id].queued || state[entry.id].key != entry.key;
+    });
+    queue.erase(end, queue.end());
+    std::make_heap(queue.begin(), queue.end());
+}
+
+void DStarLite::computeShortestPath()
+{
+    while (true) {
+        //Outdated entries are dropped first, so the top of the heap is the top of OPEN
+        while (!queue.empty() && (!state[queue.front().id].queued || state[queue.front().id].key != queue.front().key)) {
+            std::pop_heap(queue.begin(), queue.end());
+            queue.pop_back();
+        }
+        if (queue.empty())
+            break;
+        //Cells whose first key component ties with the start's are expanded too: the whole path, not only
+        //the first move, is read off the g-values, so every cell on a shortest path has to be consistent
+        Entry top = queue.front();
+        if (!keyLess(top.key, Key(calculateKey(start).first, CN_DSL_INF)) && state[start].rhs <= state[start].g)
+            break;
+        std::pop_heap(queue.begin(), queue.end());
+        queue.pop_back();
+        int u = top.id;
+        Cell &cell = state[u];
+        cell.queued = false;
+        queued--;
+        Key key = calculateKey(u);
+        if (keyLess(top.key, key)) {
+            updateVertex(u);
+            continue;
+        }
+        expansions++;
+        if (cell.g > cell.rhs) {
+            //Overconsistent: the cell gets its new (lower) g and passes it on
+            cell.g = cell.rhs;
+            double g = cell.g;
+            forNeighbours(u, [&](int s, double cost) {
+                if (s != goal && cost + g < state[s].rhs) {
+                    state[s].rhs = cost + g;
+                    updateVertex(s);
+                }
+            });
+        }
+        else {
+            //Underconsistent: the cells that relied on its old g look for another successor
+            double old = cell.g;
+            cell.g = CN_DSL_INF;
+            forNeighbours(u, [&](int s, double cost) {
+                if (s != goal && state[s].rhs == cost + old) {
+                    int next;
+                    state[s].rhs = bestSuccessor(s, next);
+                    updateVertex(s);
+                }
+            });
+            updateVertex(u);
+        }
+        compactQueue();
+    }
+}
+
+SearchResult DStarLite::replan()
+{
+    std::chrono::time_point<std::chrono::system_clock> begin, end;
+    begin = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    if (!isReady())
+        return sresult;
+    expansions = 0;
+    computeShortestPath();
+    sresult.numberofsteps = expansions;
+    sresult.nodescreated = static_cast<unsigned int>(expansions + queued);
+
+    //Each step goes to the neighbour with the smallest cost + g, which leads to the goal along a shortest path
+    if (state[start].rhs < CN_DSL_INF) {
+        Node node;
+        node.g = 0;
+        node.H = node.F = 0;
+        node.parent = -1;
+        int cur = start;
+        std::size_t limit = state.size();
+        for (std::size_t steps = 0; steps <= limit; steps++) {
+            node.i = cur / width;
+            node.j = cur % width;
+            if (!distanceonly)
+                lppath.push_back(node);
+            if (cur == goal) {
+                sresult.pathfound = true;
+                break;
+            }
+            int next;
+            double step = bestSuccessor(cur, next) - state[next < 0 ? cur : next].g;
+            if (next < 0 || state[next].g == CN_DSL_INF)
+                break;
+            node.parent = cur;
+            node.g += step;
+            cur = next;
+        }
+        if (!sresult.pathfound)
+            lppath.clear();
+        else
+            sresult.pathlength = node.g;
+    }
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) / 1000000000;
+    if (lppath.size() > 2)
+        makeSecondaryPath();
+    else
+        hppath = lppath;
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
+
+void DStarLite::updateGrid(const BitGrid &other)
+{
+    //Rows are compared a word at a time, bit position p holds column p - 1
+    for (int i = 0; i < height; i++) {
+        const uint64_t *a = grid.row(i), *b = other.row(i);
+        for (int w = 0; w < grid.stride; w++)
+            for (uint64_t diff = a[w] ^ b[w]; diff; diff &= diff - 1) {
+                int j = w * 64 + lowestBit(diff) - 1;
+                setCell(i, j, other.isObstacle(i, j));
+            }
+    }
+}
+
+SearchResult DStarLite::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    if (!isReady() || map.height != height || map.width != width || options.movementRules() != movement ||
+            map.goal_i * width + map.goal_j != goal) {
+        reset(map, options);
+    }
+    else {
+        updateGrid(map.getGrid());
+        setStart(map.start_i, map.start_j);
+    }
+    return replan();
+}
@@ -16,3 +16,14 @@ EnvironmentOptions::EnvironmentOptions(bool AS, bool AD, bool CC, int MT)
     cutcorners = CC;
 }
 
+int EnvironmentOptions::movementRules() const
+{
+    if (!allowdiagonal)
+        return CN_MR_CARDINAL;
+    if (!cutcorners)
+        return CN_MR_NOCORNER;
+    if (!allowsqueeze)
+        return CN_MR_CORNER;
+    return CN_MR_SQUEEZE;
+}
+
@@ -0,0 +1,84 @@
+#include "firstmoves.h"
+#include "pathdatabase.h"
+#include "searchkernel.h"
+#include <algorithm>
+#include <limits>
+
+#define CN_FM_EPS 1e-7 //path lengths closer than this are equal (distinct sums of 1 and sqrt(2) differ by far more)
+
+template <int Movement>
+static void linkCells(const Map &map, const std::vector<int> &cells, const std::vector<int32_t> &index,
+                      std::vector<int> &first, std::vector<uint32_t> &edges)
+{
+    first.assign(cells.size() + 1, 0);
+    edges.clear();
+    for (std::size_t r = 0; r < cells.size(); r++) {
+        int i = cells[r] / map.width, j = cells[r] % map.width;
+        for (int k = 0; k < 8; k++) {
+            int di = CPDSearch::moves[k][0], dj = CPDSearch::moves[k][1];
+            bool diagonal = (di != 0 && dj != 0);
+            if ((Movement == CN_MR_CARDINAL && diagonal) || !map.CellIsTraversable(i + di, j + dj) ||
+                    (diagonal && !diagonalMoveAllowed<Movement>(map, i, j, di, dj)))
+                continue;
+            edges.push_back(static_cast<uint32_t>(index[cells[r] + di * map.width + dj]) << 3 | k);
+        }
+        first[r + 1] = static_cast<int>(edges.size());
+    }
+}
+
+void linkCells(const Map &map, int movement, const std::vector<int> &cells, const std::vector<int32_t> &index,
+               std::vector<int> &first, std::vector<uint32_t> &edges)
+{
+    switch (movement) {
+        case CN_MR_CARDINAL:
+            linkCells<CN_MR_CARDINAL>(map, cells, index, first, edges);
+            break;
+        case CN_MR_NOCORNER:
+            linkCells<CN_MR_NOCORNER>(map, cells, index, first, edges);
+            break;
+        case CN_MR_CORNER:
+            linkCells<CN_MR_CORNER>(map, cells, index, first, edges);
+            break;
+        default:
+            linkCells<CN_MR_SQUEEZE>(map, cells, index, first, edges);
+    }
+}
+
+//Cells are queued in buckets of unit width: a move costs at least 1, so cells of one bucket cannot improve each
+//other and every predecessor on an optimal path is in an earlier bucket. A move costs less than 2, so three
+//buckets are enough as a ring.
+void firstMoves(const std::vector<int> &first, const std::vector<uint32_t> &edges, int source, FirstMoveBuffers &buffers)
+{
+    static const double diagonalCost = sqrt(2);
+    std::vector<double> &dist = buffers.dist;
+    std::vector<uint8_t> &mask = buffers.mask, &closed = buffers.closed;
+    dist.assign(first.size() - 1, std::numeric_limits<double>::infinity());
+    mask.assign(first.size() - 1, 0);
+    closed.assign(first.size() - 1, 0);
+    dist[source] = 0;
+    buffers.buckets[0].assign(1, source);
+    for (int bucket = 0, queued = 1; queued > 0; bucket++) {
+        std::vector<int> &current = buffers.buckets[bucket % 3];
+        for (std::size_t n = 0; n < current.size(); n++) {
+            int id = current[n];
+            if (closed[id])
+                continue;//queued again with a smaller distance in the same bucket
+            closed[id] = 1;
+            for (int e = first[id]; e < first[id + 1]; e++) {
+                int next = static_cast<int>(edges[e] >> 3), k = edges[e] & 7;
+                double d = dist[id] + ((CPDSearch::moves[k][0] != 0 && CPDSearch::moves[k][1] != 0) ? diagonalCost : 1);
+                uint8_t moves = (id == source ? static_cast<uint8_t>(1u << k) : mask[id]);
+                if (d < dist[next] - CN_FM_EPS) {
+                    dist[next] = d;
+                    mask[next] = moves;
+                    buffers.buckets[static_cast<int>(d) % 3].push_back(next);
+                    queued++;
+                }
+                else if (d <= dist[next] + CN_FM_EPS)
+                    mask[next] |= moves;
+            }
+        }
+        queued -= static_cast<int>(current.size());
+        current.clear();
+    }
+}
@@ -0,0 +1,139 @@
+#include "fixedpointastar.h"
+#include "searchkernel.h"
+#include <chrono>
+#include <cstdlib>
+#include <algorithm>
+
+template <int Movement>
+inline uint64_t fixedPointHeuristic(int di, int dj)
+{
+    uint64_t a = abs(di), b = abs(dj);
+    if (Movement == CN_MR_CARDINAL)
+        return (a + b) * CN_FP_STRAIGHT;
+    if (a < b)
+        std::swap(a, b);
+    return (a - b) * CN_FP_STRAIGHT + b * CN_FP_DIAGONAL;
+}
+
+template <int Movement, bool GMax>
+SearchResult FixedPointAstar<Movement, GMax>::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    if (options.movementRules() != Movement)
+        return Astar::startSearch(map, options);
+
+    //Same neighbour order as ISearch::findSuccessors
+    static const int moves[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    cells.reset(map.height, map.width);
+    if (g.size() != static_cast<std::size_t>(map.height) * map.width)
+        g.assign(static_cast<std::size_t>(map.height) * map.width, 0);
+    //F of the queued cells stays within twice the largest move cost of the smallest one
+    queue.reset(2 * CN_FP_DIAGONAL + 1);
+
+    int startId = cells.index(map.start_i, map.start_j), goalId = cells.index(map.goal_i, map.goal_j);
+    g[startId] = 0;
+    cells.setOpen(startId, 0, -1);
+    queue.push(fixedPointHeuristic<Movement>(map.goal_i - map.start_i, map.goal_j - map.start_j), 0, startId);
+    int closeSize = 0, created = 1, closestId = startId;
+    uint64_t closestH = fixedPointHeuristic<Movement>(map.goal_i - map.start_i, map.goal_j - map.start_j);
+    bool pathfound = false, stopped = false;
+    while (!queue.empty()) {
+        if (limitReached(closeSize, start)) {
+            stopped = true;
+            break;
+        }
+        typename BucketQueue<GMax>::Entry cur = queue.pop();
+        //Cells pushed again with a better g leave their outdated entries behind
+        if (cur.g != g[cur.id] || cells.isClosed(cur.id))
+            continue;
+        cells.setClosed(cur.id);
+        closeSize++;
+        if (cur.id == goalId) {
+            pathfound = true;
+            break;
+        }
+        int i = cur.id / map.width, j = cur.id - i * map.width;
+        uint64_t h = fixedPointHeuristic<Movement>(map.goal_i - i, map.goal_j - j);
+        if (h < closestH) {
+            closestH = h;
+            closestId = cur.id;
+        }
+        for (int k = 0; k < 8; k++) {
+            int di = moves[k][0], dj = moves[k][1];
+            bool diagonal = (di != 0 && dj != 0);
+            if (Movement == CN_MR_CARDINAL && diagonal)
+                continue;
+            if (!map.CellIsTraversable(i + di, j + dj) ||
+                    (diagonal && !diagonalMoveAllowed<Movement>(map, i, j, di, dj)))
+                continue;
+            int id = cur.id + di * map.width + dj;
+            uint64_t newG = cur.g + (diagonal ? CN_FP_DIAGONAL : CN_FP_STRAIGHT);
+            if (cells.isVisited(id)) {
+                if (cells.isClosed(id) || newG >= g[id])
+                    continue;
+            }
+            else
+                created++;
+            g[id] = newG;
+            cells.setOpen(id, static_cast<double>(newG) / CN_FP_STRAIGHT, cur.id);
+            queue.push(newG + fixedPointHeuristic<Movement>(map.goal_i - i - di, map.goal_j - j - dj), newG, id);
+        }
+    }
+    sresult.nodescreated = created;
+    sresult.numberofsteps = closeSize;
+    if (pathfound || stopped) {
+        sresult.pathfound = pathfound;
+        sresult.partial = stopped;
+        Node last = cells.node(pathfound ? goalId : closestId);
+        if (!distanceonly)
+            makePrimaryPath(last);
+        //The fixed-point g is rounded, the length is measured on the moves back to the start instead
+        int straight = 0, diagonal = 0;
+        for (Node cur = last; cur.parent >= 0; ) {
+            Node prev = cells.node(cur.parent);
+            if (cur.i != prev.i && cur.j != prev.j)
+                diagonal++;
+            else
+                straight++;
+            cur = prev;
+        }
+        sresult.pathlength = straight + CN_SQRT_TWO * diagonal;
+    }
+    //Stop the timer now because making path using back pointers is a part of the algorithm
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
+    if ((pathfound || stopped) && !distanceonly)
+        makeSecondaryPath();
+
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
+
+template <int Movement>
+static ISearch* createFixedPoint(bool breakingties)
+{
+    if (breakingties == CN_SP_BT_GMAX)
+        return new FixedPointAstar<Movement, true>();
+    return new FixedPointAstar<Movement, false>();
+}
+
+ISearch* createFixedPointSearch(int movement, bool breakingties)
+{
+    switch (movement) {
+        case CN_MR_CARDINAL:
+            return createFixedPoint<CN_MR_CARDINAL>(breakingties);
+        case CN_MR_NOCORNER:
+            return createFixedPoint<CN_MR_NOCORNER>(breakingties);
+        case CN_MR_CORNER:
+            return createFixedPoint<CN_MR_CORNER>(breakingties);
+        case CN_MR_SQUEEZE:
+            return createFixedPoint<CN_MR_SQUEEZE>(breakingties);
+        default:
+            return nullptr;
+    }
+}
@@ -0,0 +1,160 @@
+#include "goalbounds.h"
+#include "firstmoves.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+static const char gbMagic[4] = {'G', 'B', 'N', 'D'};
+
+GoalBounds::GoalBounds()
+{
+    height = 0;
+    width = 0;
+    movement = CN_MR_NOCORNER;
+    buildTime = 0;
+}
+
+bool GoalBounds::fits(const Map &map, const EnvironmentOptions &options) const
+{
+    return movement == options.movementRules() && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t GoalBounds::memoryUsage() const
+{
+    return node.size() * sizeof(int32_t) + boxes.size() * sizeof(Box);
+}
+
+void GoalBounds::numberCells(std::vector<int> &cells)
+{
+    node.assign(static_cast<std::size_t>(height) * width, -1);
+    cells.clear();
+    for (int i = 0; i < height; i++)
+        for (int j = 0; j < width; j++)
+            if (!grid->isObstacle(i, j)) {
+                node[static_cast<std::size_t>(i) * width + j] = static_cast<int32_t>(cells.size());
+                cells.push_back(i * width + j);
+            }
+}
+
+std::shared_ptr<const GoalBounds> GoalBounds::build(const Map &map, const EnvironmentOptions &options, int threads)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<GoalBounds> result = std::make_shared<GoalBounds>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = options.movementRules();
+    result->grid = map.getSharedGrid();
+    std::vector<int> cells;
+    result->numberCells(cells);
+    Box empty = {0xFFFF, 0, 0xFFFF, 0}, all = {0, 0xFFFF, 0, 0xFFFF};
+    //Rows and columns beyond 16 bits cannot be stored, such maps get boxes that allow every move
+    if (map.height > 0xFFFF || map.width > 0xFFFF) {
+        result->boxes.assign(cells.size() * 8, all);
+        result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return result;
+    }
+    result->boxes.assign(cells.size() * 8, empty);
+
+    std::vector<int> first;
+    std::vector<uint32_t> edges;
+    linkCells(map, result->movement, cells, result->node, first, edges);
+    ThreadPool pool(threads);
+    std::vector<FirstMoveBuffers> buffers(pool.size());
+    pool.run(static_cast<int>(cells.size()), [&](int worker, int source) {
+        firstMoves(first, edges, source, buffers[worker]);
+        const std::vector<uint8_t> &mask = buffers[worker].mask;
+        Box *box = &result->boxes[static_cast<std::size_t>(source) * 8];
+        for (std::size_t target = 0; target < cells.size(); target++) {
+            if (!mask[target])
+                continue;
+            uint16_t i = static_cast<uint16_t>(cells[target] / map.width), j = static_cast<uint16_t>(cells[target] % map.width);
+            for (unsigned int moves = mask[target]; moves; moves &= moves - 1) {
+                Box &b = box[lowestBit(moves)];
+                b.min_i = std::min(b.min_i, i);
+                b.max_i = std::max(b.max_i, i);
+                b.min_j = std::min(b.min_j, j);
+                b.max_j = std::max(b.max_j, j);
+            }
+        }
+    });
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+bool GoalBounds::save(const std::string &fileName) const
+{
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    int32_t header[4] = {CN_GB_VERSION, height, width, movement};
+    uint64_t sizes[2] = {grid->fingerprint(), boxes.size() / 8};
+    file.write(gbMagic, sizeof(gbMagic));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+    //The cell numbers follow from the grid, so only the boxes are written
+    file.write(reinterpret_cast<const char *>(boxes.data()), boxes.size() * sizeof(Box));
+    file.close();
+    return !file.fail();
+}
+
+std::shared_ptr<const GoalBounds> GoalBounds::load(const std::string &fileName, const Map &map)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    char magic[4];
+    int32_t header[4];
+    uint64_t sizes[2];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    file.read(reinterpret_cast<char *>(sizes), sizeof(sizes));
+    if (!file || memcmp(magic, gbMagic, sizeof(magic)) != 0 || header[0] != CN_GB_VERSION ||
+            header[1] != map.height || header[2] != map.width || header[3] < 0 || header[3] >= CN_MR_COUNT ||
+            sizes[0] != map.getGrid().fingerprint())
+        return nullptr;
+
+    std::shared_ptr<GoalBounds> result = std::make_shared<GoalBounds>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = header[3];
+    result->grid = map.getSharedGrid();
+    std::vector<int> cells;
+    result->numberCells(cells);
+    if (sizes[1] != cells.size())
+        return nullptr;
+    result->boxes.resize(cells.size() * 8);
+    file.read(reinterpret_cast<char *>(result->boxes.data()), result->boxes.size() * sizeof(Box));
+    if (!file)
+        return nullptr;
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+GoalBoundedAstar::GoalBoundedAstar(double HW, bool BT, std::shared_ptr<const GoalBounds> bounds):Astar(HW, BT)
+{
+    this->bounds = bounds;
+    goal_i = -1;
+    goal_j = -1;
+}
+
+void GoalBoundedAstar::initSearch(const Map &map, const EnvironmentOptions &options)
+{
+    if (!bounds || !bounds->fits(map, options)) {
+        bounds = GoalBounds::build(map, options);
+        sresult.preprocessingtime = bounds->buildTime;
+    }
+    sresult.preprocessingmemory = bounds->memoryUsage();
+    goal_i = map.goal_i;
+    goal_j = map.goal_j;
+}
+
+int GoalBoundedAstar::findSuccessors(const Node &curNode, const Map &map, const EnvironmentOptions &options, Node *successors)
+{
+    int count = Astar::findSuccessors(curNode, map, options, successors), kept = 0;
+    for (int k = 0; k < count; k++)
+        if (bounds->allows(curNode.i, curNode.j, successors[k].i - curNode.i, successors[k].j - curNode.j, goal_i, goal_j))
+            successors[kept++] = successors[k];
+    return kept;
+}
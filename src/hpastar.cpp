@@ -0,0 +1,388 @@
+#include "hpastar.h"
+#include "searchkernel.h"
+#include "threadpool.h"
+#include <chrono>
+#include <queue>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <stdint.h>
+
+ClusterGraph::ClusterGraph()
+{
+    height = 0;
+    width = 0;
+    clustersHigh = 0;
+    clustersWide = 0;
+    movement = CN_MR_NOCORNER;
+    buildTime = 0;
+}
+
+bool ClusterGraph::fits(const Map &map, const EnvironmentOptions &options) const
+{
+    return movement == options.movementRules() && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t ClusterGraph::memoryUsage() const
+{
+    std::size_t size = cells.size() * sizeof(int);
+    for (std::size_t k = 0; k < edges.size(); k++)
+        size += edges[k].size() * sizeof(Edge);
+    for (std::size_t k = 0; k < members.size(); k++)
+        size += members[k].size() * sizeof(int);
+    return size;
+}
+
+void ClusterGraph::clusterDistances(int i, int j, std::vector<double> &dist) const
+{
+    const int side = CN_HPA_CLUSTER;
+    int top = i / side * side, left = j / side * side;
+    int rows = std::min(side, height - top), columns = std::min(side, width - left);
+    //The search runs on a copy of the cluster with a blocked border and on integer costs (as the fixed-point A*),
+    //the lengths are summed in double along the way
+    bool free[(side + 2) * (side + 2)];
+    unsigned int cost[(side + 2) * (side + 2)];
+    const int stride = side + 2;
+    for (int k = 0; k < stride * stride; k++)
+        free[k] = false;
+    for (int di = 0; di < rows; di++)
+        for (int dj = 0; dj < columns; dj++)
+            free[(di + 1) * stride + dj + 1] = !grid->isObstacle(top + di, left + dj);
+    dist.assign(side * side, -1);
+    int moves[8], steps = 0;
+    for (int di = -1; di <= 1; di++)
+        for (int dj = -1; dj <= 1; dj++)
+            if ((di != 0 || dj != 0) && (movement != CN_MR_CARDINAL || di == 0 || dj == 0))
+                moves[steps++] = di * stride + dj;
+    //Entries are cost << 32 | cell, so the smallest cost comes first
+    std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> queue;
+    int source = (i - top + 1) * stride + j - left + 1;
+    cost[source] = 0;
+    dist[local(i, j)] = 0;
+    queue.push(source);
+    while (!queue.empty()) {
+        uint64_t entry = queue.top();
+        queue.pop();
+        int cur = static_cast<int>(entry & 0xffffffffu), ci = cur / stride - 1, cj = cur % stride - 1;
+        unsigned int g = static_cast<unsigned int>(entry >> 32);
+        if (g > cost[cur])
+            continue;
+        for (int k = 0; k < steps; k++) {
+            int next = cur + moves[k];
+            if (!free[next])
+                continue;
+            int di = next / stride - 1 - ci, dj = next % stride - 1 - cj;
+            bool diagonal = (di != 0 && dj != 0);
+            if (diagonal) {
+                bool first = free[cur + dj], second = free[cur + di * stride];
+                if ((movement == CN_MR_NOCORNER && !(first && second)) || (movement == CN_MR_CORNER && !(first || second)))
+                    continue;
+            }
+            unsigned int newCost = g + (diagonal ? CN_FP_DIAGONAL : CN_FP_STRAIGHT);
+            int id = (ci + di) * side + cj + dj;
+            if (dist[id] >= 0 && newCost >= cost[next])
+                continue;
+            cost[next] = newCost;
+            dist[id] = dist[ci * side + cj] + (diagonal ? CN_SQRT_TWO : 1);
+            queue.push(static_cast<uint64_t>(newCost) << 32 | static_cast<unsigned int>(next));
+        }
+    }
+}
+
+std::shared_ptr<const ClusterGraph> ClusterGraph::build(const Map &map, const EnvironmentOptions &options, int threads)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<ClusterGraph> result = std::make_shared<ClusterGraph>();
+    ClusterGraph &graph = *result;
+    graph.height = map.height;
+    graph.width = map.width;
+    graph.clustersHigh = (map.height + CN_HPA_CLUSTER - 1) / CN_HPA_CLUSTER;
+    graph.clustersWide = (map.width + CN_HPA_CLUSTER - 1) / CN_HPA_CLUSTER;
+    graph.movement = options.movementRules();
+    graph.grid = map.getSharedGrid();
+    graph.members.resize(static_cast<std::size_t>(graph.clustersHigh) * graph.clustersWide);
+    const BitGrid &grid = *graph.grid;
+
+    //Transitions: a cell may end up in several of them (at the corners of a cluster), it is one node
+    std::unordered_map<int, int> nodes;
+    auto node = [&](int i, int j) {
+        int cell = i * map.width + j;
+        std::unordered_map<int, int>::const_iterator it = nodes.find(cell);
+        if (it != nodes.end())
+            return it->second;
+        int id = static_cast<int>(graph.cells.size());
+        nodes[cell] = id;
+        graph.cells.push_back(cell);
+        graph.edges.push_back(std::vector<Edge>());
+        graph.members[graph.cluster(i, j)].push_back(id);
+        return id;
+    };
+    auto transition = [&](int i1, int j1, int i2, int j2) {
+        int a = node(i1, j1), b = node(i2, j2);
+        Edge ab = {b, 1}, ba = {a, 1};
+        graph.edges[a].push_back(ab);
+        graph.edges[b].push_back(ba);
+    };
+    //Entrances along the border between rows i and i + 1 (vertical = false) or columns j and j + 1,
+    //'length' cells long, starting at the other coordinate 'first'
+    auto entrances = [&](bool vertical, int line, int first, int length) {
+        int run = 0;
+        for (int k = 0; k <= length; k++) {
+            int i1 = vertical ? first + k : line, j1 = vertical ? line : first + k;
+            int i2 = vertical ? i1 : i1 + 1, j2 = vertical ? j1 + 1 : j1;
+            if (k < length && !grid.isObstacle(i1, j1) && !grid.isObstacle(i2, j2)) {
+                run++;
+                continue;
+            }
+            if (run > 0) {
+                int last = k - 1, start = k - run;
+                if (run < CN_HPA_SPLIT)
+                    start = last = start + run / 2;
+                for (int at = start; at <= last; at += std::max(last - start, 1)) {
+                    if (vertical)
+                        transition(first + at, line, first + at, line + 1);
+                    else
+                        transition(line, first + at, line + 1, first + at);
+                }
+            }
+            run = 0;
+        }
+    };
+    for (int ci = 0; ci < graph.clustersHigh; ci++)
+        for (int cj = 0; cj < graph.clustersWide; cj++) {
+            int top = ci * CN_HPA_CLUSTER, left = cj * CN_HPA_CLUSTER;
+            int bottom = std::min(top + CN_HPA_CLUSTER, map.height), right = std::min(left + CN_HPA_CLUSTER, map.width);
+            if (bottom < map.height)
+                entrances(false, bottom - 1, left, right - left);
+            if (right < map.width)
+                entrances(true, right - 1, top, bottom - top);
+        }
+
+    //Paths inside the clusters. Every node belongs to one cluster, so the workers write to different edge lists
+    ThreadPool pool(threads);
+    std::vector<std::vector<double>> dist(pool.size());
+    pool.run(static_cast<int>(graph.members.size()), [&](int worker, int c) {
+        const std::vector<int> &inside = graph.members[c];
+        for (std::size_t a = 0; a < inside.size(); a++) {
+            int cell = graph.cells[inside[a]];
+            graph.clusterDistances(cell / map.width, cell % map.width, dist[worker]);
+            for (std::size_t b = 0; b < inside.size(); b++) {
+                int other = graph.cells[inside[b]];
+                double d = dist[worker][local(other / map.width, other % map.width)];
+                if (a != b && d > 0) {
+                    Edge edge = {inside[b], d};
+                    graph.edges[inside[a]].push_back(edge);
+                }
+            }
+        }
+    });
+    graph.buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+HPAStar::HPAStar(double HW, bool BT, bool anyAngle, std::shared_ptr<const ClusterGraph> graph) : Astar(HW, BT)
+{
+    this->anyAngle = anyAngle;
+    this->graph = graph;
+}
+
+const ClusterGraph& HPAStar::useGraph(const Map &map, const EnvironmentOptions &options)
+{
+    if (!graph || !graph->fits(map, options)) {
+        graph = ClusterGraph::build(map, options);
+        sresult.preprocessingtime += graph->buildTime;
+    }
+    sresult.preprocessingmemory = graph->memoryUsage();
+    return *graph;
+}
+
+ISearch& HPAStar::refiner(const EnvironmentOptions &options)
+{
+    if (!engine || engineOptions.metrictype != options.metrictype || engineOptions.movementRules() != options.movementRules()) {
+        int searchtype = (anyAngle ? CN_SP_ST_TH : CN_SP_ST_ASTAR);
+        engine.reset(createSearchKernel(searchtype, options.metrictype, options.movementRules(), breakingties, hweight));
+        if (!engine && anyAngle)
+            engine.reset(new Theta(hweight, breakingties));
+        else if (!engine)
+            engine.reset(new Astar(hweight, breakingties));
+        engineOptions = options;
+    }
+    return *engine;
+}
+
+bool HPAStar::findCoarsePath(const Map &map, const EnvironmentOptions &options, std::vector<int> &waypoints)
+{
+    const ClusterGraph &graph = useGraph(map, options);
+    waypoints.clear();
+    int start = map.start_i * map.width + map.start_j, goal = map.goal_i * map.width + map.goal_j;
+    int startCluster = graph.cluster(map.start_i, map.start_j), goalCluster = graph.cluster(map.goal_i, map.goal_j);
+    graph.clusterDistances(map.start_i, map.start_j, startDist);
+    graph.clusterDistances(map.goal_i, map.goal_j, goalDist);
+
+    //The abstract search reuses 'cells' and 'open' as a height x 1 grid: row n is node n,
+    //row S the start and row G the goal, which are only linked to the nodes of their clusters
+    int S = static_cast<int>(graph.cells.size()), G = S + 1;
+    auto cellOf = [&](int n) {return n == S ? start : (n == G ? goal : graph.cells[n]);};
+    auto heuristic = [&](int n) {
+        int cell = cellOf(n);
+        int di = cell / map.width - map.goal_i, dj = cell % map.width - map.goal_j;
+        if (graph.movement == CN_MR_CARDINAL)
+            return ManhattanMetric::distance(di, dj);
+        return DiagonalMetric::distance(di, dj);
+    };
+    cells.reset(G + 1, 1);
+    open.reset(G + 1, 1);
+    open.setOrder(TieBreak(breakingties));
+    Node curNode;
+    curNode.i = S;
+    curNode.j = 0;
+    curNode.g = 0;
+    curNode.H = heuristic(S);
+    curNode.F = hweight * curNode.H;
+    curNode.parent = -1;
+    addOpen(curNode);
+    auto relax = [&](int n, double cost) {
+        if (cells.isClosed(n))
+            return;
+        Node newNode;
+        newNode.i = n;
+        newNode.j = 0;
+        newNode.g = curNode.g + cost;
+        newNode.H = heuristic(n);
+        newNode.F = newNode.g + hweight * newNode.H;
+        newNode.parent = curNode.i;
+        addOpen(newNode);
+    };
+    bool pathfound = false;
+    while (!open.empty()) {
+        curNode = open.top();
+        open.pop();
+        cells.setClosed(curNode.i);
+        sresult.numberofsteps++;
+        sresult.nodescreated++;
+        if (curNode.i == G) {
+            pathfound = true;
+            break;
+        }
+        if (curNode.i == S) {
+            const std::vector<int> &inside = graph.members[startCluster];
+            for (std::size_t k = 0; k < inside.size(); k++) {
+                int cell = graph.cells[inside[k]];
+                double d = startDist[ClusterGraph::local(cell / map.width, cell % map.width)];
+                if (d >= 0)
+                    relax(inside[k], d);
+            }
+            if (startCluster == goalCluster && startDist[ClusterGraph::local(map.goal_i, map.goal_j)] >= 0)
+                relax(G, startDist[ClusterGraph::local(map.goal_i, map.goal_j)]);
+            continue;
+        }
+        const std::vector<ClusterGraph::Edge> &out = graph.edges[curNode.i];
+        for (std::size_t k = 0; k < out.size(); k++)
+            relax(out[k].to, out[k].cost);
+        int cell = graph.cells[curNode.i];
+        if (graph.cluster(cell / map.width, cell % map.width) == goalCluster) {
+            double d = goalDist[ClusterGraph::local(cell / map.width, cell % map.width)];
+            if (d >= 0)
+                relax(G, d);
+        }
+    }
+    sresult.nodescreated += open.size();
+    if (!pathfound)
+        return false;
+    for (int n = G; n >= 0; n = cells[n].parent)
+        if (waypoints.empty() || waypoints.back() != cellOf(n))
+            waypoints.push_back(cellOf(n));
+    std::reverse(waypoints.begin(), waypoints.end());
+    return true;
+}
+
+double HPAStar::refine(const Map &map, const EnvironmentOptions &options, int from, int to,
+                       std::list<Node> &lowLevel, std::list<Node> &highLevel)
+{
+    Map segment = map;
+    if (!segment.setEndpoints(from % map.width, from / map.width, to % map.width, to / map.width))
+        return -1;
+    ISearch &engine = refiner(options);
+    engine.setDistanceOnly(distanceonly);
+    SearchResult result = engine.startSearch(segment, options);
+    sresult.numberofsteps += result.numberofsteps;
+    sresult.nodescreated += result.nodescreated;
+    if (!result.pathfound)
+        return -1;
+    if (distanceonly)
+        return result.pathlength;
+    for (std::list<Node>::const_iterator it = result.lppath->begin(); it != result.lppath->end(); ++it)
+        if (lowLevel.empty() || !(lowLevel.back() == *it))
+            lowLevel.push_back(*it);
+    //The raster of a Theta* path leaves out its last cell
+    if (!(lowLevel.back().i == segment.goal_i && lowLevel.back().j == segment.goal_j)) {
+        Node last = result.hppath->back();
+        lowLevel.push_back(last);
+    }
+    for (std::list<Node>::const_iterator it = result.hppath->begin(); it != result.hppath->end(); ++it)
+        if (highLevel.empty() || !(highLevel.back() == *it))
+            highLevel.push_back(*it);
+    return result.pathlength;
+}
+
+SearchResult HPAStar::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    std::vector<int> waypoints;
+    if (!findCoarsePath(map, options, waypoints)) {
+        waypoints.clear();
+        waypoints.push_back(map.start_i * map.width + map.start_j);
+        waypoints.push_back(map.goal_i * map.width + map.goal_j);
+    }
+    if (waypoints.size() == 1)
+        waypoints.push_back(waypoints.front());
+    double length = 0;
+    sresult.pathfound = true;
+    for (std::size_t k = 0; k + 1 < waypoints.size() && sresult.pathfound; k++) {
+        double segment = refine(map, options, waypoints[k], waypoints[k + 1], lppath, hppath);
+        if (segment < 0)
+            sresult.pathfound = false;
+        length += segment;
+    }
+    if (sresult.pathfound)
+        sresult.pathlength = length;
+    else {
+        lppath.clear();
+        hppath.clear();
+    }
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
+    sresult.time -= sresult.preprocessingtime;
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
+
+HierarchicalPath::HierarchicalPath(const Map &map, const EnvironmentOptions &options, double HW, bool BT, bool anyAngle,
+                                   std::shared_ptr<const ClusterGraph> graph)
+    : map(map), options(options), search(HW, BT, anyAngle, graph)
+{
+    if (search.findCoarsePath(map, options, waypoints)) {
+        if (waypoints.size() == 1)
+            waypoints.push_back(waypoints.front());
+        return;
+    }
+    //Not in the graph: a single segment for the full search, unless that finds no path either
+    waypoints.push_back(map.start_i * map.width + map.start_j);
+    waypoints.push_back(map.goal_i * map.width + map.goal_j);
+    std::list<Node> path;
+    if (!refine(0, path))
+        waypoints.clear();
+}
+
+bool HierarchicalPath::refine(int k, std::list<Node> &path)
+{
+    std::list<Node> highLevel;
+    path.clear();
+    return k >= 0 && k < segments() && search.refine(map, options, waypoints[k], waypoints[k + 1], path, highLevel) >= 0;
+}
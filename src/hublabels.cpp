@@ -0,0 +1,380 @@
+#include "hublabels.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define CN_HL_EPS 1e-7 //path lengths closer than this are equal, as in the contraction hierarchy
+
+static const char hlMagic[4] = {'H', 'L', 'A', 'B'};
+
+//First 64 bytes of a file, followed by the offsets, the hubs (padded to 8 bytes) and the distances, so every
+//array of a mapped file is aligned
+struct HubLabelsHeader
+{
+    char        magic[4];
+    int32_t     version, height, width, movement, reserved;
+    uint64_t    fingerprint, nodes, entries, padding[2];
+};
+
+HubLabels::HubLabels()
+{
+    height = 0;
+    width = 0;
+    movement = CN_MR_NOCORNER;
+    buildTime = 0;
+    offsets = nullptr;
+    hubs = nullptr;
+    distances = nullptr;
+    entries = 0;
+    mapping = nullptr;
+    mappingSize = 0;
+}
+
+HubLabels::~HubLabels()
+{
+#ifndef _WIN32
+    if (mapping)
+        munmap(mapping, mappingSize);
+#endif
+}
+
+bool HubLabels::fits(const Map &map, const EnvironmentOptions &options) const
+{
+    return movement == options.movementRules() && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t HubLabels::memoryUsage() const
+{
+    return (node.size() + cells.size()) * sizeof(int32_t) + (cells.size() + 1) * sizeof(uint64_t) +
+           entries * (sizeof(uint32_t) + sizeof(double));
+}
+
+void HubLabels::numberCells()
+{
+    node.assign(static_cast<std::size_t>(height) * width, -1);
+    cells.clear();
+    for (int i = 0; i < height; i++)
+        for (int j = 0; j < width; j++)
+            if (!grid->isObstacle(i, j)) {
+                node[static_cast<std::size_t>(i) * width + j] = static_cast<int32_t>(cells.size());
+                cells.push_back(i * width + j);
+            }
+}
+
+double HubLabels::distance(int v, int w) const
+{
+    const uint32_t *a = hubs + offsets[v], *aEnd = hubs + offsets[v + 1];
+    const uint32_t *b = hubs + offsets[w], *bEnd = hubs + offsets[w + 1];
+    double best = std::numeric_limits<double>::infinity();
+    while (a != aEnd && b != bEnd) {
+        if (*a < *b)
+            a++;
+        else if (*b < *a)
+            b++;
+        else {
+            best = std::min(best, distances[a - hubs] + distances[b - hubs]);
+            a++;
+            b++;
+        }
+    }
+    return best < std::numeric_limits<double>::infinity() ? best : -1;
+}
+
+//Label of one node while the labels are made
+struct Label
+{
+    std::vector<uint32_t>   hubs;
+    std::vector<double>     distances;
+};
+
+//Per-worker buffers: the distances of the label being made by hub, and the hubs set in them
+struct LabelBuffers
+{
+    std::vector<double>     dist;
+    std::vector<uint32_t>   touched;
+};
+
+//Label of v from the finished labels of the nodes its upward arcs lead to
+static void makeLabel(const ContractionHierarchy &hierarchy, int v, std::vector<Label> &labels, LabelBuffers &buffers)
+{
+    std::vector<double> &dist = buffers.dist;
+    std::vector<uint32_t> &touched = buffers.touched;
+    touched.assign(1, static_cast<uint32_t>(v));
+    dist[v] = 0;
+    for (uint32_t a = hierarchy.first[v]; a < hierarchy.first[v + 1]; a++) {
+        const ContractionHierarchy::Arc &arc = hierarchy.arcs[a];
+        const Label &above = labels[arc.head];
+        for (std::size_t k = 0; k < above.hubs.size(); k++) {
+            uint32_t hub = above.hubs[k];
+            double d = arc.cost + above.distances[k];
+            if (dist[hub] == std::numeric_limits<double>::infinity())
+                touched.push_back(hub);
+            dist[hub] = std::min(dist[hub], d);
+        }
+    }
+    std::sort(touched.begin(), touched.end());
+
+    //A hub is dropped if the label, which is exact as a whole, meets the label of the hub on a shorter path
+    Label &label = labels[v];
+    for (std::size_t k = 0; k < touched.size(); k++) {
+        uint32_t hub = touched[k];
+        double d = dist[hub];
+        bool dominated = false;
+        if (hub != static_cast<uint32_t>(v)) {
+            const Label &other = labels[hub];
+            for (std::size_t m = 0; m < other.hubs.size() && !dominated; m++)
+                dominated = (dist[other.hubs[m]] + other.distances[m] < d - CN_HL_EPS);
+        }
+        if (!dominated) {
+            label.hubs.push_back(hub);
+            label.distances.push_back(d);
+        }
+    }
+    for (std::size_t k = 0; k < touched.size(); k++)
+        dist[touched[k]] = std::numeric_limits<double>::infinity();
+}
+
+std::shared_ptr<const HubLabels> HubLabels::build(const Map &map, const EnvironmentOptions &options, int threads,
+                                                  std::shared_ptr<const ContractionHierarchy> hierarchy)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    if (!hierarchy || !hierarchy->fits(map, options))
+        hierarchy = ContractionHierarchy::build(map, options, threads);
+    std::shared_ptr<HubLabels> result = std::make_shared<HubLabels>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = options.movementRules();
+    result->grid = map.getSharedGrid();
+    result->node = hierarchy->node;
+    result->cells = hierarchy->cells;
+
+    //Levels from the top: a node is on the level after the highest of the nodes its arcs lead to
+    int n = hierarchy->nodes();
+    std::vector<uint32_t> pending(n), downFirst(n + 1, 0), down(hierarchy->arcs.size());
+    std::vector<int> level;
+    for (int v = 0; v < n; v++) {
+        pending[v] = hierarchy->first[v + 1] - hierarchy->first[v];
+        for (uint32_t a = hierarchy->first[v]; a < hierarchy->first[v + 1]; a++)
+            downFirst[hierarchy->arcs[a].head + 1]++;
+        if (pending[v] == 0)
+            level.push_back(v);
+    }
+    for (int v = 0; v < n; v++)
+        downFirst[v + 1] += downFirst[v];
+    std::vector<uint32_t> fill(downFirst.begin(), downFirst.end() - 1);
+    for (int v = 0; v < n; v++)
+        for (uint32_t a = hierarchy->first[v]; a < hierarchy->first[v + 1]; a++)
+            down[fill[hierarchy->arcs[a].head]++] = static_cast<uint32_t>(v);
+
+    std::vector<Label> labels(n);
+    ThreadPool pool(threads);
+    std::vector<LabelBuffers> buffers(pool.size());
+    for (int k = 0; k < pool.size(); k++)
+        buffers[k].dist.assign(n, std::numeric_limits<double>::infinity());
+    std::vector<int> next;
+    while (!level.empty()) {
+        pool.run(static_cast<int>(level.size()), [&](int worker, int k) {
+            makeLabel(*hierarchy, level[k], labels, buffers[worker]);
+        });
+        next.clear();
+        for (std::size_t k = 0; k < level.size(); k++)
+            for (uint32_t d = downFirst[level[k]]; d < downFirst[level[k] + 1]; d++)
+                if (--pending[down[d]] == 0)
+                    next.push_back(down[d]);
+        level.swap(next);
+    }
+
+    result->offsetData.assign(n + 1, 0);
+    for (int v = 0; v < n; v++)
+        result->offsetData[v + 1] = result->offsetData[v] + labels[v].hubs.size();
+    result->entries = result->offsetData[n];
+    result->hubData.reserve(result->entries);
+    result->distanceData.reserve(result->entries);
+    for (int v = 0; v < n; v++) {
+        result->hubData.insert(result->hubData.end(), labels[v].hubs.begin(), labels[v].hubs.end());
+        result->distanceData.insert(result->distanceData.end(), labels[v].distances.begin(), labels[v].distances.end());
+        std::vector<uint32_t>().swap(labels[v].hubs);
+        std::vector<double>().swap(labels[v].distances);
+    }
+    result->offsets = result->offsetData.data();
+    result->hubs = result->hubData.data();
+    result->distances = result->distanceData.data();
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+bool HubLabels::save(const std::string &fileName) const
+{
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    HubLabelsHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, hlMagic, sizeof(hlMagic));
+    header.version = CN_HL_VERSION;
+    header.height = height;
+    header.width = width;
+    header.movement = movement;
+    header.fingerprint = grid->fingerprint();
+    header.nodes = cells.size();
+    header.entries = entries;
+    static const char zeros[8] = {0};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(offsets), (cells.size() + 1) * sizeof(uint64_t));
+    file.write(reinterpret_cast<const char *>(hubs), entries * sizeof(uint32_t));
+    file.write(zeros, (entries % 2) * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char *>(distances), entries * sizeof(double));
+    file.close();
+    return !file.fail();
+}
+
+std::shared_ptr<const HubLabels> HubLabels::load(const std::string &fileName, const Map &map)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<HubLabels> result = std::make_shared<HubLabels>();
+    result->height = map.height;
+    result->width = map.width;
+    result->grid = map.getSharedGrid();
+    result->numberCells();
+    uint64_t n = result->cells.size();
+
+    HubLabelsHeader header;
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || memcmp(header.magic, hlMagic, sizeof(hlMagic)) != 0 || header.version != CN_HL_VERSION ||
+            header.height != map.height || header.width != map.width || header.movement < 0 ||
+            header.movement >= CN_MR_COUNT || header.fingerprint != map.getGrid().fingerprint() || header.nodes != n ||
+            header.entries >= (uint64_t(1) << 40))
+        return nullptr;
+    result->movement = header.movement;
+    result->entries = header.entries;
+    uint64_t offsetsAt = sizeof(header), hubsAt = offsetsAt + (n + 1) * sizeof(uint64_t);
+    uint64_t distancesAt = hubsAt + (header.entries + header.entries % 2) * sizeof(uint32_t);
+    uint64_t size = distancesAt + header.entries * sizeof(double);
+
+#ifndef _WIN32
+    //The labels stay in the file and are paged in as queries read them
+    file.close();
+    int descriptor = open(fileName.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return nullptr;
+    struct stat status;
+    void *mapping = MAP_FAILED;
+    if (fstat(descriptor, &status) == 0 && static_cast<uint64_t>(status.st_size) == size)
+        mapping = mmap(nullptr, size, PROT_READ, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+    if (mapping == MAP_FAILED)
+        return nullptr;
+    result->mapping = mapping;
+    result->mappingSize = size;
+    const char *data = static_cast<const char *>(mapping);
+    result->offsets = reinterpret_cast<const uint64_t *>(data + offsetsAt);
+    result->hubs = reinterpret_cast<const uint32_t *>(data + hubsAt);
+    result->distances = reinterpret_cast<const double *>(data + distancesAt);
+#else
+    result->offsetData.resize(n + 1);
+    result->hubData.resize(header.entries + header.entries % 2);
+    result->distanceData.resize(header.entries);
+    file.read(reinterpret_cast<char *>(result->offsetData.data()), result->offsetData.size() * sizeof(uint64_t));
+    file.read(reinterpret_cast<char *>(result->hubData.data()), result->hubData.size() * sizeof(uint32_t));
+    file.read(reinterpret_cast<char *>(result->distanceData.data()), result->distanceData.size() * sizeof(double));
+    if (!file || file.peek() != std::ifstream::traits_type::eof())
+        return nullptr;
+    result->offsets = result->offsetData.data();
+    result->hubs = result->hubData.data();
+    result->distances = result->distanceData.data();
+#endif
+    //Queries only compare hubs, so the offsets are all that must be checked to keep reads inside the arrays
+    if (result->offsets[0] != 0 || result->offsets[n] != header.entries)
+        return nullptr;
+    for (uint64_t v = 0; v < n; v++)
+        if (result->offsets[v] > result->offsets[v + 1])
+            return nullptr;
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+HLSearch::HLSearch(std::shared_ptr<const HubLabels> labels, std::shared_ptr<const ContractionHierarchy> hierarchy)
+    :Astar(1, CN_SP_BT_GMAX)
+{
+    this->labels = labels;
+    this->hierarchy = hierarchy;
+}
+
+SearchResult HLSearch::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    if (!labels || !labels->fits(map, options)) {
+        labels = HubLabels::build(map, options, 0, hierarchy);
+        hierarchy.reset();
+        sresult.preprocessingtime = labels->buildTime;
+    }
+    sresult.preprocessingmemory = labels->memoryUsage();
+
+    //numberofsteps counts the label merges
+    double length = labels->distance(map.start_i, map.start_j, map.goal_i, map.goal_j), left = length;
+    sresult.numberofsteps = 1;
+    bool pathfound = (length >= 0);
+    if (pathfound && !distanceonly) {
+        cells.reset(map.height, map.width);
+        Node curNode, successors[CN_MAX_SUCCESSORS];
+        curNode.i = map.start_i;
+        curNode.j = map.start_j;
+        curNode.g = 0;
+        curNode.H = 0;
+        curNode.F = 0;
+        curNode.parent = -1;
+        lppath.push_back(curNode);
+        while (pathfound && !(curNode.i == map.goal_i && curNode.j == map.goal_j)) {
+            cells.setClosed(cells.index(curNode.i, curNode.j));
+            int count = findSuccessors(curNode, map, options, successors), k = 0;
+            double next = -1;
+            for (; k < count; k++) {
+                next = labels->distance(successors[k].i, successors[k].j, map.goal_i, map.goal_j);
+                sresult.numberofsteps++;
+                if (next >= 0 && std::fabs(successors[k].g - curNode.g + next - left) < CN_HL_EPS)
+                    break;
+            }
+            //No neighbour is on a shortest path only with labels that do not belong to the map
+            pathfound = (k < count);
+            if (!pathfound)
+                break;
+            successors[k].parent = cells.index(curNode.i, curNode.j);
+            successors[k].H = 0;
+            successors[k].F = successors[k].g;
+            curNode = successors[k];
+            left = next;
+            lppath.push_back(curNode);
+        }
+        if (!pathfound)
+            lppath.clear();
+    }
+    if (pathfound) {
+        sresult.pathfound = true;
+        sresult.pathlength = distanceonly ? length : lppath.back().g;
+    }
+    sresult.nodescreated = static_cast<unsigned int>(lppath.size());
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
+    sresult.time -= sresult.preprocessingtime;
+    if (pathfound && !distanceonly)
+        makeSecondaryPath();
+
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
@@ -1,76 +1,101 @@
 #include "isearch.h"
 #include <vector>
 #include <math.h>
-#include <limits>
 #include <chrono>
 
 ISearch::ISearch()
 {
     hweight = 1;
     breakingties = CN_SP_BT_GMAX;
-    openSize = 0;
+    maxexpansions = 0;
+    maxtime = 0;
+    distanceonly = false;
 }
 
 ISearch::~ISearch(void) {}
 
+void ISearch::setLimits(unsigned int maxExpansions, double maxTime)
+{
+    maxexpansions = maxExpansions;
+    maxtime = maxTime;
+}
+
 bool ISearch::stopCriterion()
 {
-    if (openSize == 0) {
-        std::cout << "OPEN list is empty!" << std::endl;
-        return true;
-    }
-    return false;
+    //No output here: searches run concurrently, an exhausted OPEN list is reported as pathfound = false
+    return open.empty();
 }
 
 SearchResult ISearch::startSearch(const Map &map, const EnvironmentOptions &options)
 {
     std::chrono::time_point<std::chrono::system_clock> start, end;
     start = std::chrono::system_clock::now();
-    open.resize(map.height);
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    cells.reset(map.height, map.width);
+    open.reset(map.height, map.width);
+    open.setOrder(TieBreak(breakingties));
+    initSearch(map, options);
+    //Tables built by initSearch are not counted against the time limit, as in sresult.time
+    std::chrono::time_point<std::chrono::system_clock> limitStart = std::chrono::system_clock::now();
     Node curNode;
     curNode.i = map.start_i;
     curNode.j = map.start_j;
     curNode.g = 0;
     curNode.H = computeHFromCellToCell(curNode.i, curNode.j, map.goal_i, map.goal_j, options);
     curNode.F = hweight * curNode.H;
-    curNode.parent = nullptr;
+    curNode.parent = -1;
     addOpen(curNode);
     int closeSize = 0;
-    bool pathfound = false;
+    bool pathfound = false, stopped = false;
+    Node successors[CN_MAX_SUCCESSORS], closest = curNode;
     while (!stopCriterion()) {
+        if (limitReached(closeSize, limitStart)) {
+            stopped = true;
+            break;
+        }
         curNode = findMin();
-        close.insert({curNode.i * map.width + curNode.j, curNode});
+        open.pop();
+        int curId = cells.index(curNode.i, curNode.j);
+        cells.setClosed(curId);
         closeSize++;
-        open[curNode.i].pop_front();
-        openSize--;
         if (curNode.i == map.goal_i && curNode.j == map.goal_j) {
             pathfound = true;
             break;
         }
-        std::list<Node> successors = findSuccessors(curNode, map, options);
-        std::list<Node>::iterator it = successors.begin();
-        auto parent = &(close.find(curNode.i * map.width + curNode.j)->second);
-        while (it != successors.end()) {
-            it->parent = parent;
-            it->H = computeHFromCellToCell(it->i, it->j, map.goal_i, map.goal_j, options);
-            *it = resetParent(*it, *it->parent, map, options);
-            it->F = it->g + hweight * it->H;
-            addOpen(*it);
-            it++;
+        if (curNode.H < closest.H)
+            closest = curNode;
+        int count = findSuccessors(curNode, map, options, successors);
+        for (int k = 0; k < count; k++) {
+            Node &successor = successors[k];
+            successor.parent = curId;
+            successor.H = computeHFromCellToCell(successor.i, successor.j, map.goal_i, map.goal_j, options);
+            successor = resetParent(successor, curNode, map, options);
+            successor.F = successor.g + hweight * successor.H;
+            addOpen(successor);
         }
     }
     sresult.pathfound = false;
-    sresult.nodescreated = closeSize + openSize;
+    sresult.nodescreated = closeSize + open.size();
     sresult.numberofsteps = closeSize;
     if (pathfound) {
         sresult.pathfound = true;
-        makePrimaryPath(curNode);
+        if (!distanceonly)
+            makePrimaryPath(curNode);
         sresult.pathlength = curNode.g;
     }
+    else if (stopped) {
+        sresult.partial = true;
+        if (!distanceonly)
+            makePrimaryPath(closest);
+        sresult.pathlength = closest.g;
+    }
     //Stop the timer now because making path using back pointers is a part of the algorithm
     end = std::chrono::system_clock::now();
     sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
-    if (pathfound)
+    sresult.time -= sresult.preprocessingtime;
+    if ((pathfound || stopped) && !distanceonly)
         makeSecondaryPath();
 
     sresult.hppath = &hppath; //Here is a constant pointer
@@ -80,28 +105,16 @@ SearchResult ISearch::startSearch(const Map &map, const EnvironmentOptions &opti
 
 Node ISearch::findMin()
 {
-    Node min;
-    min.F = std::numeric_limits<double>::infinity();
-    for (int i = 0; i < open.size(); i++)
-        if (!open[i].empty() && open[i].begin()->F <= min.F)
-            if (open[i].begin()->F == min.F){
-                if((breakingties == CN_SP_BT_GMAX && open[i].begin()->g >= min.g) ||
-                   (breakingties == CN_SP_BT_GMIN && open[i].begin()->g <= min.g))
-                    min = *open[i].begin();
-            }
-            else
-                min = *open[i].begin();
-    return min;
+    return open.top();
 }
 
-std::list<Node> ISearch::findSuccessors(Node curNode, const Map &map, const EnvironmentOptions &options)
+int ISearch::findSuccessors(const Node &curNode, const Map &map, const EnvironmentOptions &options, Node *successors)
 {
-    Node newNode;
-    std::list<Node> successors;
-    for (int i = -1; i <= +1; i++)
-        for (int j = -1; j <= +1; j++)
-            if ((i != 0 || j != 0) && map.CellOnGrid(curNode.i + i, curNode.j + j) &&
-                    (map.CellIsTraversable(curNode.i + i, curNode.j + j))) {
+    //Neighbours outside the grid fall on the obstacle border of the map, so no bounds checks are needed
+    int count = 0;
+    for (int i = +1; i >= -1; i--)
+        for (int j = +1; j >= -1; j--)
+            if ((i != 0 || j != 0) && map.CellIsTraversable(curNode.i + i, curNode.j + j)) {
                 if (i != 0 && j != 0) {
                     if (!options.allowdiagonal)
                         continue;
@@ -116,31 +129,36 @@ std::list<Node> ISearch::findSuccessors(Node curNode, const Map &map, const Envi
                             continue;
                     }
                 }
-                if (close.find((curNode.i + i) * map.width + curNode.j + j) == close.end()) {
+                if (!cells.isClosed(cells.index(curNode.i + i, curNode.j + j))) {
+                    Node &newNode = successors[count++];
                     newNode.i = curNode.i + i;
                     newNode.j = curNode.j + j;
                     if(i == 0 || j == 0)
                         newNode.g = curNode.g + 1;
                     else
                         newNode.g = curNode.g + sqrt(2);
-                    successors.push_front(newNode);
                 }
             }
-    return successors;
+    return count;
 }
 
 void ISearch::makePrimaryPath(Node curNode)
 {
     Node current = curNode;
-    while (current.parent) {
+    while (current.parent >= 0) {
         lppath.push_front(current);
-        current = *current.parent;
+        current = cells.node(current.parent);
     }
     lppath.push_front(current);
 }
 
 void ISearch::makeSecondaryPath()
 {
+    //Paths of one or two cells have no turns (and the loop below looks two cells ahead)
+    if (lppath.size() < 3) {
+        hppath = lppath;
+        return;
+    }
     std::list<Node>::const_iterator iter = lppath.begin();
     int curI, curJ, nextI, nextJ, moveI, moveJ;
     hppath.push_back(*iter);
@@ -162,46 +180,6 @@ void ISearch::makeSecondaryPath()
 
 void ISearch::addOpen(Node newNode)
 {
-    std::list<Node>::iterator iter, pos;
-
-    if (open[newNode.i].size() == 0) {
-        open[newNode.i].push_back(newNode);
-        openSize++;
-        return;
-    }
-
-    pos = open[newNode.i].end();
-    bool posFound = false;
-    for (iter = open[newNode.i].begin(); iter != open[newNode.i].end(); ++iter) {
-        if (!posFound && iter->F >= newNode.F)
-            if (iter->F == newNode.F) {
-                if((breakingties == CN_SP_BT_GMAX && newNode.g >= iter->g) ||
-                   (breakingties == CN_SP_BT_GMIN && newNode.g <= iter->g)) {
-                    pos=iter;
-                    posFound=true;
-                }
-            }
-            else {
-                pos = iter;
-                posFound = true;
-            }
-
-        if (iter->j == newNode.j) {
-            if (newNode.F >= iter->F)
-                return;
-            else {
-                if (pos == iter) {
-                    iter->F = newNode.F;
-                    iter->g = newNode.g;
-                    iter->parent = newNode.parent;
-                    return;
-                }
-                open[newNode.i].erase(iter);
-                openSize--;
-                break;
-            }
-        }
-    }
-    openSize++;
-    open[newNode.i].insert(pos, newNode);
+    if (open.push(newNode))
+        cells.setOpen(cells.index(newNode.i, newNode.j), newNode.g, newNode.parent);
 }
@@ -0,0 +1,289 @@
+#include "jps.h"
+
+JPS::~JPS()
+{
+}
+
+void JPS::initSearch(const Map &map, const EnvironmentOptions &options)
+{
+    movement = options.movementRules();
+    goal_i = map.goal_i;
+    goal_j = map.goal_j;
+    grid = &map.getGrid();
+    //Later searches on the same grid reuse the transposed copy
+    if (movement != CN_MR_CARDINAL && columnsSource != map.getSharedGrid()) {
+        grid->transpose(columns);
+        columnsSource = map.getSharedGrid();
+    }
+    useGoalBounds(map, options);
+}
+
+void JPS::useGoalBounds(const Map &map, const EnvironmentOptions &options)
+{
+    if (!goalBounding)
+        return;
+    if (!bounds || !bounds->fits(map, options)) {
+        bounds = GoalBounds::build(map, options);
+        sresult.preprocessingtime += bounds->buildTime;
+    }
+    sresult.preprocessingmemory += bounds->memoryUsage();
+}
+
+bool JPS::canStep(int i, int j, int di, int dj) const
+{
+    if (grid->isObstacle(i + di, j + dj))
+        return false;
+    if (di == 0 || dj == 0)
+        return true;
+    bool obstacle1 = grid->isObstacle(i, j + dj);
+    bool obstacle2 = grid->isObstacle(i + di, j);
+    switch (movement) {
+        case CN_MR_NOCORNER:
+            return !obstacle1 && !obstacle2;
+        case CN_MR_CORNER:
+            return !obstacle1 || !obstacle2;
+        case CN_MR_SQUEEZE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool JPS::hasForcedNeighbour(int i, int j, int di, int dj) const
+{
+    //Without corner cutting both cells adjacent to a diagonal move are free, so nothing can be forced
+    if (movement != CN_MR_CORNER && movement != CN_MR_SQUEEZE)
+        return false;
+    return (grid->isObstacle(i - di, j) && canStep(i, j, -di, dj)) ||
+           (grid->isObstacle(i, j - dj) && canStep(i, j, di, -dj));
+}
+
+bool JPS::isStraightJumpPoint(int i, int j, int di, int dj) const
+{
+    //Same rule as the bitwise scan of jumpStraight, applied to a single cell
+    bool corner = (movement == CN_MR_CORNER || movement == CN_MR_SQUEEZE);
+    for (int side = -1; side <= 1; side += 2) {
+        int si = dj * side, sj = di * side;
+        if (corner) {
+            if (grid->isObstacle(i + si, j + sj) && !grid->isObstacle(i + si + di, j + sj + dj))
+                return true;
+        }
+        else if (grid->isObstacle(i + si - di, j + sj - dj) && !grid->isObstacle(i + si, j + sj))
+            return true;
+    }
+    return false;
+}
+
+bool JPS::jumpStraight(const BitGrid &scan, int row, int col, int dir, int goalRow, int goalCol, int &result) const
+{
+    //A cell is a jump point when an obstacle run in a neighbouring row ends next to it: with corner
+    //cutting it is the last cell beside the run, otherwise the first free cell after it.
+    //The border guarantees that a blocked bit stops the scan inside the row.
+    const uint64_t *up = scan.row(row - 1);
+    const uint64_t *cur = scan.row(row);
+    const uint64_t *down = scan.row(row + 1);
+    const uint64_t full = ~uint64_t(0);
+    bool corner = (movement == CN_MR_CORNER || movement == CN_MR_SQUEEZE);
+    int last = scan.stride - 1;
+    int stop = -1;
+    if (dir > 0) {
+        int pos = col + 2;
+        uint64_t mask = full << (pos & 63);
+        for (int w = pos >> 6; w <= last; w++) {
+            uint64_t forced;
+            if (corner) {
+                uint64_t upNext = (up[w] >> 1) | ((w < last ? up[w + 1] : full) << 63);
+                uint64_t downNext = (down[w] >> 1) | ((w < last ? down[w + 1] : full) << 63);
+                forced = (up[w] & ~upNext) | (down[w] & ~downNext);
+            }
+            else {
+                uint64_t upPrev = (up[w] << 1) | (w > 0 ? up[w - 1] >> 63 : 1);
+                uint64_t downPrev = (down[w] << 1) | (w > 0 ? down[w - 1] >> 63 : 1);
+                forced = (upPrev & ~up[w]) | (downPrev & ~down[w]);
+            }
+            uint64_t candidates = (cur[w] | forced) & mask;
+            if (candidates) {
+                stop = (w << 6) + lowestBit(candidates) - 1;
+                break;
+            }
+            mask = full;
+        }
+    }
+    else {
+        int pos = col;
+        uint64_t mask = ((pos & 63) == 63) ? full : (uint64_t(1) << ((pos & 63) + 1)) - 1;
+        for (int w = pos >> 6; w >= 0; w--) {
+            uint64_t upPrev = (up[w] << 1) | (w > 0 ? up[w - 1] >> 63 : 1);
+            uint64_t downPrev = (down[w] << 1) | (w > 0 ? down[w - 1] >> 63 : 1);
+            uint64_t forced;
+            if (corner)
+                forced = (up[w] & ~upPrev) | (down[w] & ~downPrev);
+            else {
+                uint64_t upNext = (up[w] >> 1) | ((w < last ? up[w + 1] : full) << 63);
+                uint64_t downNext = (down[w] >> 1) | ((w < last ? down[w + 1] : full) << 63);
+                forced = (upNext & ~up[w]) | (downNext & ~down[w]);
+            }
+            uint64_t candidates = (cur[w] | forced) & mask;
+            if (candidates) {
+                stop = (w << 6) + highestBit(candidates) - 1;
+                break;
+            }
+            mask = full;
+        }
+    }
+    if (row == goalRow && (goalCol - col) * dir > 0 && (stop - goalCol) * dir >= 0) {
+        result = goalCol;
+        return true;
+    }
+    if (scan.isObstacle(row, stop))
+        return false;
+    result = stop;
+    return true;
+}
+
+bool JPS::jumpVertical(int i, int j, int di, int &jump_i) const
+{
+    if (movement != CN_MR_CARDINAL)
+        return jumpStraight(columns, j, i, di, goal_j, goal_i, jump_i);
+    //Straight-only moves prefer vertical steps, so every step of a vertical jump looks along its row
+    int col;
+    for (i += di; !grid->isObstacle(i, j); i += di)
+        if ((i == goal_i && j == goal_j) || jumpStraight(*grid, i, j, 1, goal_i, goal_j, col) ||
+                jumpStraight(*grid, i, j, -1, goal_i, goal_j, col)) {
+            jump_i = i;
+            return true;
+        }
+    return false;
+}
+
+bool JPS::jump(int i, int j, int di, int dj, int &jump_i, int &jump_j) const
+{
+    if (di == 0) {
+        jump_i = i;
+        return jumpStraight(*grid, i, j, dj, goal_i, goal_j, jump_j);
+    }
+    if (dj == 0) {
+        jump_j = j;
+        return jumpVertical(i, j, di, jump_i);
+    }
+    int found;
+    while (canStep(i, j, di, dj)) {
+        i += di;
+        j += dj;
+        if ((i == goal_i && j == goal_j) || hasForcedNeighbour(i, j, di, dj) ||
+                jumpStraight(*grid, i, j, dj, goal_i, goal_j, found) || jumpVertical(i, j, di, found)) {
+            jump_i = i;
+            jump_j = j;
+            return true;
+        }
+    }
+    return false;
+}
+
+int JPS::prunedDirections(const Node &curNode, int directions[8][2]) const
+{
+    int count = 0;
+    int i = curNode.i, j = curNode.j;
+    if (curNode.parent < 0) {
+        for (int di = -1; di <= 1; di++)
+            for (int dj = -1; dj <= 1; dj++)
+                if ((di != 0 || dj != 0) && (movement != CN_MR_CARDINAL || di == 0 || dj == 0)) {
+                    directions[count][0] = di;
+                    directions[count++][1] = dj;
+                }
+    }
+    else {
+        Node parent = cells.node(curNode.parent);
+        int di = (i > parent.i) - (i < parent.i);
+        int dj = (j > parent.j) - (j < parent.j);
+        directions[count][0] = di;
+        directions[count++][1] = dj;
+        if (di != 0 && dj != 0) {
+            directions[count][0] = di;
+            directions[count++][1] = 0;
+            directions[count][0] = 0;
+            directions[count++][1] = dj;
+            if (grid->isObstacle(i - di, j) && movement != CN_MR_NOCORNER) {
+                directions[count][0] = -di;
+                directions[count++][1] = dj;
+            }
+            if (grid->isObstacle(i, j - dj) && movement != CN_MR_NOCORNER) {
+                directions[count][0] = di;
+                directions[count++][1] = -dj;
+            }
+        }
+        else {
+            for (int side = -1; side <= 1; side += 2) {
+                int si = dj * side, sj = di * side;
+                if (movement == CN_MR_CARDINAL && di != 0) {
+                    directions[count][0] = si;
+                    directions[count++][1] = sj;
+                }
+                else if (movement == CN_MR_CARDINAL || movement == CN_MR_NOCORNER) {
+                    if (grid->isObstacle(i + si - di, j + sj - dj) && !grid->isObstacle(i + si, j + sj)) {
+                        directions[count][0] = si;
+                        directions[count++][1] = sj;
+                        if (movement == CN_MR_NOCORNER) {
+                            directions[count][0] = si + di;
+                            directions[count++][1] = sj + dj;
+                        }
+                    }
+                }
+                else if (grid->isObstacle(i + si, j + sj)) {
+                    directions[count][0] = si + di;
+                    directions[count++][1] = sj + dj;
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+int JPS::findSuccessors(const Node &curNode, const Map &, const EnvironmentOptions &, Node *successors)
+{
+    int directions[8][2];
+    int count = prunedDirections(curNode, directions);
+    int i = curNode.i, j = curNode.j;
+    int found = 0;
+    for (int k = count - 1; k >= 0; k--) {
+        int di = directions[k][0], dj = directions[k][1];
+        Node &newNode = successors[found];
+        if (goalBounding && !bounds->allows(i, j, di, dj, goal_i, goal_j))
+            continue;
+        if (!jump(i, j, di, dj, newNode.i, newNode.j) || cells.isClosed(cells.index(newNode.i, newNode.j)))
+            continue;
+        int steps = std::max(std::abs(newNode.i - i), std::abs(newNode.j - j));
+        newNode.g = curNode.g + ((di != 0 && dj != 0) ? steps * sqrt(2) : steps);
+        found++;
+    }
+    return found;
+}
+
+void JPS::makePrimaryPath(Node curNode)
+{
+    Node current = curNode;
+    while(current.parent >= 0) {
+        hppath.push_front(current);
+        current = cells.node(current.parent);
+    }
+    hppath.push_front(current);
+}
+
+void JPS::makeSecondaryPath()
+{
+    //Consecutive jump points always lie on one straight or diagonal line
+    std::list<Node>::const_iterator iter = hppath.begin();
+    lppath.push_back(*iter);
+    for (++iter; iter != hppath.end(); ++iter) {
+        Node inpath = lppath.back();
+        int di = (iter->i > inpath.i) - (iter->i < inpath.i);
+        int dj = (iter->j > inpath.j) - (iter->j < inpath.j);
+        while (inpath.i != iter->i || inpath.j != iter->j) {
+            inpath.i += di;
+            inpath.j += dj;
+            lppath.push_back(inpath);
+        }
+        lppath.back() = *iter;
+    }
+}
@@ -0,0 +1,142 @@
+#include "jpsplus.h"
+#include <chrono>
+
+JumpTable::JumpTable()
+{
+    height = 0;
+    width = 0;
+    movement = CN_MR_NOCORNER;
+    buildTime = 0;
+}
+
+bool JumpTable::fits(const Map &map, const EnvironmentOptions &options) const
+{
+    return movement == options.movementRules() && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t JumpTable::memoryUsage() const
+{
+    return distances.size() * sizeof(int16_t);
+}
+
+JPSPlus::JPSPlus(double hweight, bool breakingties, std::shared_ptr<const JumpTable> table, bool goalBounding,
+                 std::shared_ptr<const GoalBounds> bounds):JPS(hweight, breakingties, goalBounding, bounds)
+{
+    this->table = table;
+}
+
+JPSPlus::~JPSPlus()
+{
+}
+
+std::shared_ptr<const JumpTable> JPSPlus::preprocess(const Map &map, const EnvironmentOptions &options)
+{
+    JPSPlus builder(1, CN_SP_BT_GMAX);
+    return builder.buildJumpTable(map, options);
+}
+
+void JPSPlus::initSearch(const Map &map, const EnvironmentOptions &options)
+{
+    goal_i = map.goal_i;
+    goal_j = map.goal_j;
+    if (!table || !table->fits(map, options)) {
+        table = buildJumpTable(map, options);
+        sresult.preprocessingtime = table->buildTime;
+    }
+    sresult.preprocessingmemory = table->memoryUsage();
+    grid = table->grid.get();
+    movement = table->movement;
+    useGoalBounds(map, options);
+}
+
+std::shared_ptr<JumpTable> JPSPlus::buildJumpTable(const Map &map, const EnvironmentOptions &options)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<JumpTable> result = std::make_shared<JumpTable>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = options.movementRules();
+    result->grid = map.getSharedGrid();
+    result->distances.assign(static_cast<std::size_t>(map.height) * map.width * 8, 0);
+    grid = result->grid.get();
+    movement = result->movement;
+
+    //Every jump is one step followed by the jump of the next cell, so each direction is a single sweep
+    //that visits cells after their neighbour in that direction. Straight jumps go first as diagonal
+    //jumps (and vertical jumps with straight-only moves) stop where they find one.
+    static const int order[8][2] = {{0, -1}, {0, 1}, {-1, 0}, {1, 0}, {-1, -1}, {-1, 1}, {1, -1}, {1, 1}};
+    int count = (movement == CN_MR_CARDINAL ? 4 : 8);
+    for (int k = 0; k < count; k++) {
+        int di = order[k][0], dj = order[k][1];
+        int dir = JumpTable::direction(di, dj);
+        for (int n = 0; n < map.height; n++) {
+            int i = (di > 0 ? map.height - 1 - n : n);
+            for (int m = 0; m < map.width; m++) {
+                int j = (dj > 0 ? map.width - 1 - m : m);
+                if (grid->isObstacle(i, j) || !canStep(i, j, di, dj))
+                    continue;
+                int ni = i + di, nj = j + dj;
+                bool stop;
+                if (di != 0 && dj != 0)
+                    stop = hasForcedNeighbour(ni, nj, di, dj) || result->distance(ni, nj, JumpTable::direction(0, dj)) > 0 ||
+                           result->distance(ni, nj, JumpTable::direction(di, 0)) > 0;
+                else if (movement == CN_MR_CARDINAL && di != 0)
+                    stop = result->distance(ni, nj, JumpTable::direction(0, -1)) > 0 ||
+                           result->distance(ni, nj, JumpTable::direction(0, 1)) > 0;
+                else
+                    stop = isStraightJumpPoint(ni, nj, di, dj);
+                int next = result->distance(ni, nj, dir);
+                int value;
+                if (stop)
+                    value = 1;
+                else if (next > 0)
+                    value = std::min(next + 1, CN_JT_MAX_DIST);
+                else
+                    value = (-next < CN_JT_MAX_DIST ? next - 1 : CN_JT_MAX_DIST);
+                result->distances[(static_cast<std::size_t>(i) * map.width + j) * 8 + dir] = static_cast<int16_t>(value);
+            }
+        }
+    }
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+bool JPSPlus::jump(int i, int j, int di, int dj, int &jump_i, int &jump_j) const
+{
+    int dist = table->distance(i, j, JumpTable::direction(di, dj));
+    int reach = std::abs(dist);
+    int to_goal_i = goal_i - i, to_goal_j = goal_j - j;
+    //The table knows nothing about the goal: stop on it, or on the cell of the jump from which
+    //the goal lies straight ahead
+    if (di != 0 && dj != 0) {
+        if (to_goal_i * di > 0 && to_goal_j * dj > 0) {
+            int steps = std::min(std::abs(to_goal_i), std::abs(to_goal_j));
+            if (steps <= reach) {
+                jump_i = i + di * steps;
+                jump_j = j + dj * steps;
+                return true;
+            }
+        }
+    }
+    else if (movement == CN_MR_CARDINAL && di != 0) {
+        if (to_goal_i * di > 0 && to_goal_i * di <= reach) {
+            jump_i = goal_i;
+            jump_j = j;
+            return true;
+        }
+    }
+    else if ((di == 0 ? to_goal_i : to_goal_j) == 0) {
+        int steps = (di == 0 ? to_goal_j * dj : to_goal_i * di);
+        if (steps > 0 && steps <= reach) {
+            jump_i = goal_i;
+            jump_j = goal_j;
+            return true;
+        }
+    }
+    if (dist <= 0)
+        return false;
+    jump_i = i + di * dist;
+    jump_j = j + dj * dist;
+    return true;
+}
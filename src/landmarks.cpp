@@ -0,0 +1,212 @@
+#include "landmarks.h"
+#include "searchkernel.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+LandmarkTable::LandmarkTable()
+{
+    height = 0;
+    width = 0;
+    movement = CN_MR_NOCORNER;
+    requested = 0;
+    count = 0;
+    step = 1;
+    scale = 0.5;
+    buildTime = 0;
+}
+
+bool LandmarkTable::fits(const Map &map, const EnvironmentOptions &options, int count) const
+{
+    return movement == options.movementRules() && requested == count && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t LandmarkTable::memoryUsage() const
+{
+    return distances.size() * sizeof(uint32_t) + landmarks.size() * sizeof(int);
+}
+
+static const int landmarkMoves[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+
+//Number of moves from the cell 'source' to every cell (-1 where it cannot go), returns the largest
+template <int Movement>
+static int countMoves(const Map &map, int source, std::vector<int> &moves, std::vector<int> &queue)
+{
+    std::fill(moves.begin(), moves.end(), -1);
+    moves[source] = 0;
+    queue.assign(1, source);
+    for (std::size_t n = 0; n < queue.size(); n++) {
+        int id = queue[n], i = id / map.width, j = id - i * map.width;
+        for (int k = 0; k < 8; k++) {
+            int di = landmarkMoves[k][0], dj = landmarkMoves[k][1];
+            bool diagonal = (di != 0 && dj != 0);
+            if ((Movement == CN_MR_CARDINAL && diagonal) || !map.CellIsTraversable(i + di, j + dj) ||
+                    (diagonal && !diagonalMoveAllowed<Movement>(map, i, j, di, dj)))
+                continue;
+            int next = id + di * map.width + dj;
+            if (moves[next] < 0) {
+                moves[next] = moves[id] + 1;
+                queue.push_back(next);
+            }
+        }
+    }
+    return moves[queue.back()];
+}
+
+struct DistanceBuffers
+{
+    std::vector<double>     dist;
+    std::vector<int>        buckets[3];
+};
+
+//Shortest distances from the cell 'source' to every cell (infinity where it cannot go). A move costs at least 1,
+//so the cells are queued in buckets of unit width that cannot improve each other, three of them as a ring
+template <int Movement>
+static void findDistances(const Map &map, int source, DistanceBuffers &buffers)
+{
+    static const double diagonalCost = sqrt(2);
+    std::vector<double> &dist = buffers.dist;
+    std::vector<int> (&buckets)[3] = buffers.buckets;
+    std::fill(dist.begin(), dist.end(), std::numeric_limits<double>::infinity());
+    dist[source] = 0;
+    buckets[0].assign(1, source);
+    for (int bucket = 0, queued = 1; queued > 0; bucket++) {
+        std::vector<int> &current = buckets[bucket % 3];
+        for (std::size_t n = 0; n < current.size(); n++) {
+            int id = current[n], i = id / map.width, j = id - i * map.width;
+            if (static_cast<int>(dist[id]) != bucket)
+                continue;//queued again with a smaller distance
+            for (int k = 0; k < 8; k++) {
+                int di = landmarkMoves[k][0], dj = landmarkMoves[k][1];
+                bool diagonal = (di != 0 && dj != 0);
+                if ((Movement == CN_MR_CARDINAL && diagonal) || !map.CellIsTraversable(i + di, j + dj) ||
+                        (diagonal && !diagonalMoveAllowed<Movement>(map, i, j, di, dj)))
+                    continue;
+                int next = id + di * map.width + dj;
+                double d = dist[id] + (diagonal ? diagonalCost : 1);
+                if (d < dist[next]) {
+                    dist[next] = d;
+                    buckets[static_cast<int>(d) % 3].push_back(next);
+                    queued++;
+                }
+            }
+        }
+        queued -= static_cast<int>(current.size());
+        current.clear();
+    }
+}
+
+template <int Movement>
+static void buildTable(const Map &map, LandmarkTable &table, int threads)
+{
+    //The landmarks go to the largest component, smaller ones fall back to the metric
+    std::shared_ptr<const ComponentLabels> labels = ComponentLabels::build(map, Movement);
+    std::vector<int> sizes(labels->count, 0);
+    for (std::size_t id = 0; id < labels->labels.size(); id++)
+        if (labels->labels[id] >= 0)
+            sizes[labels->labels[id]]++;
+    if (sizes.empty())
+        return;
+    int largest = static_cast<int>(std::max_element(sizes.begin(), sizes.end()) - sizes.begin());
+    int count = std::max(1, std::min(std::min(table.requested, CN_LM_MAX), sizes[largest]));
+
+    //Farthest-point selection: the first landmark is the cell farthest from a cell of the component, every next
+    //one the cell whose nearest landmark is farthest. minMoves is the number of moves to the nearest landmark
+    std::size_t cells = labels->labels.size();
+    std::vector<int> moves(cells), minMoves(cells, std::numeric_limits<int>::max()), queue;
+    int from = static_cast<int>(std::find(labels->labels.begin(), labels->labels.end(), largest) - labels->labels.begin());
+    countMoves<Movement>(map, from, moves, queue);
+    int maxMoves = 0;
+    table.landmarks.push_back(queue.back());
+    while (true) {
+        maxMoves = std::max(maxMoves, countMoves<Movement>(map, table.landmarks.back(), moves, queue));
+        if (static_cast<int>(table.landmarks.size()) == count)
+            break;
+        int farthest = -1;
+        for (std::size_t n = 0; n < queue.size(); n++) {
+            int id = queue[n];
+            minMoves[id] = std::min(minMoves[id], moves[id]);
+            if (farthest < 0 || minMoves[id] > minMoves[farthest])
+                farthest = id;
+        }
+        if (minMoves[farthest] == 0)
+            break;//every cell of the component is a landmark
+        table.landmarks.push_back(farthest);
+    }
+    table.count = static_cast<int>(table.landmarks.size());
+
+    //No distance exceeds sqrt(2) times the number of moves, the largest value is kept for unreachable cells
+    table.step = std::max(maxMoves * sqrt(2) / (CN_LM_UNREACHABLE - 1), 1e-3);
+    table.scale = table.step / (1 + table.step);
+    table.distances.assign(cells * table.count, CN_LM_UNREACHABLE);
+    ThreadPool pool(threads);
+    std::vector<DistanceBuffers> buffers(pool.size());
+    pool.run(table.count, [&](int worker, int k) {
+        std::vector<double> &dist = buffers[worker].dist;
+        dist.resize(cells);
+        findDistances<Movement>(map, table.landmarks[k], buffers[worker]);
+        for (std::size_t id = 0; id < cells; id++)
+            if (dist[id] < std::numeric_limits<double>::infinity())
+                table.distances[id * table.count + k] = static_cast<uint32_t>(std::min(
+                    std::floor(dist[id] / table.step), static_cast<double>(CN_LM_UNREACHABLE - 1)));
+    });
+}
+
+std::shared_ptr<const LandmarkTable> LandmarkTable::build(const Map &map, const EnvironmentOptions &options, int count,
+                                                          int threads)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<LandmarkTable> result = std::make_shared<LandmarkTable>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = options.movementRules();
+    result->requested = count;
+    result->grid = map.getSharedGrid();
+    LandmarkTable &table = *result;
+    switch (result->movement) {
+        case CN_MR_CARDINAL:
+            buildTable<CN_MR_CARDINAL>(map, table, threads);
+            break;
+        case CN_MR_NOCORNER:
+            buildTable<CN_MR_NOCORNER>(map, table, threads);
+            break;
+        case CN_MR_CORNER:
+            buildTable<CN_MR_CORNER>(map, table, threads);
+            break;
+        default:
+            buildTable<CN_MR_SQUEEZE>(map, table, threads);
+    }
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+ALTAstar::ALTAstar(double HW, bool BT, int count, std::shared_ptr<const LandmarkTable> table):Astar(HW, BT)
+{
+    this->count = std::max(1, std::min(count, CN_LM_MAX));
+    this->table = table;
+    goal_i = -1;
+    goal_j = -1;
+    goalDistances = nullptr;
+}
+
+void ALTAstar::initSearch(const Map &map, const EnvironmentOptions &options)
+{
+    if (!table || !table->fits(map, options, count)) {
+        table = LandmarkTable::build(map, options, count);
+        sresult.preprocessingtime = table->buildTime;
+    }
+    sresult.preprocessingmemory = table->memoryUsage();
+    goal_i = map.goal_i;
+    goal_j = map.goal_j;
+    goalDistances = table->count > 0 ? table->distancesOf(goal_i, goal_j) : nullptr;
+}
+
+double ALTAstar::computeHFromCellToCell(int i1, int j1, int i2, int j2, const EnvironmentOptions &options)
+{
+    double h = Astar::computeHFromCellToCell(i1, j1, i2, j2, options);
+    if (!goalDistances || i2 != goal_i || j2 != goal_j)
+        return h;
+    return std::max(h, table->bound(table->distancesOf(i1, j1), goalDistances));
+}
@@ -8,7 +8,6 @@ Map::Map()
     start_j = -1;
     goal_i = -1;
     goal_j = -1;
-    Grid = nullptr;
     cellSize = 1;
 }
 
@@ -16,54 +15,71 @@ Map::~Map()
 {
 }
 
-bool Map::CellIsTraversable(int i, int j) const
+bool Map::CellOnGrid(int i, int j) const
 {
-    return ((*Grid)[i][j] == CN_GC_NOOBS);
+    return (i < height && i >= 0 && j < width && j >= 0);
 }
 
-bool Map::CellIsObstacle(int i, int j) const
+bool Map::getMap(const std::vector<std::vector<int>>& map, int startx, int starty, int finishx, int finishy, double cell_size)
 {
-    return ((*Grid)[i][j] != CN_GC_NOOBS);
+    if (map.empty() || map[0].empty()) {
+        std::cout << "Error! Empty map provided!" << std::endl;
+        return false;
+    }
+    height = map.size();
+    width = map[0].size();
+    std::shared_ptr<BitGrid> grid = std::make_shared<BitGrid>();
+    grid->assign(height, width);
+    for (int i = 0; i < height; i++)
+        grid->fillRow(i, map[i].data());
+    Cells = grid;
+    cellSize = cell_size;
+    return setEndpoints(startx, starty, finishx, finishy, true);
 }
 
-bool Map::CellOnGrid(int i, int j) const
+bool Map::getMap(const signed char *map, int height, int width, int startx, int starty, int finishx, int finishy, double cell_size)
 {
-    return (i < height && i >= 0 && j < width && j >= 0);
+    return loadGrid(map, height, width, cell_size) && setEndpoints(startx, starty, finishx, finishy, true);
 }
 
-bool Map::getMap(const std::vector<std::vector<int>>& map, int startx, int starty, int finishx, int finishy, int cell_size)
+bool Map::loadGrid(const signed char *map, int height, int width, double cell_size)
 {
-    Grid = &map;
-    if (!Grid || Grid->empty() || (*Grid)[0].empty()) {
+    if (!map || height <= 0 || width <= 0) {
         std::cout << "Error! Empty map provided!" << std::endl;
         return false;
     }
-    height = map.size();
-    width = map[0].size();
+    this->height = height;
+    this->width = width;
+    std::shared_ptr<BitGrid> grid = std::make_shared<BitGrid>();
+    grid->assign(height, width);
+    for (int i = 0; i < height; i++)
+        grid->fillRow(i, map + static_cast<std::size_t>(i) * width);
+    Cells = grid;
+    cellSize = cell_size;
+    return true;
+}
 
+bool Map::setEndpoints(int startx, int starty, int finishx, int finishy, bool report)
+{
     // printf("Map size: %d x %d\n", height, width);
     start_i = starty;
     start_j = startx;
     goal_i = finishy;
     goal_j = finishx;
-    cellSize = cell_size;
 
     // printf("Start cell: (%d, %d)\n", start_i, start_j);
     // printf("Goal cell: (%d, %d)\n", goal_i, goal_j);
     // printf("Cell size: %f\n", cellSize);
-    // printf("Start cell value: %d\n", (*Grid)[start_i][start_j]);
-    // printf("Goal cell value: %d\n", (*Grid)[goal_i][goal_j]);
-    // printf("CN_GC_NOOBS: %d\n", CN_GC_NOOBS);
 
-    if ((*Grid)[start_i][start_j] != CN_GC_NOOBS) {
-        std::cout << "Error! Start cell is not traversable (cell's value is" << (*Grid)[start_i][start_j] << ")!"
-                  << std::endl;
+    if (!CellOnGrid(start_i, start_j) || CellIsObstacle(start_i, start_j)) {
+        if (report)
+            std::cout << "Error! Start cell is not traversable!" << std::endl;
         return false;
     }
 
-    if ((*Grid)[goal_i][goal_j] != CN_GC_NOOBS) {
-        std::cout << "Error! Goal cell is not traversable (cell's value is" << (*Grid)[goal_i][goal_j] << ")!"
-                  << std::endl;
+    if (!CellOnGrid(goal_i, goal_j) || CellIsObstacle(goal_i, goal_j)) {
+        if (report)
+            std::cout << "Error! Goal cell is not traversable!" << std::endl;
         return false;
     }
 
@@ -78,5 +94,5 @@ int Map::getValue(int i, int j) const
     if (j < 0 || j >= width)
         return -1;
 
-    return (*Grid)[i][j];
+    return CellIsObstacle(i, j) ? CN_GC_OBS : CN_GC_NOOBS;
 }
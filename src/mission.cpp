@@ -1,18 +1,34 @@
 #include "mission.h"
 #include "astar.h"
 #include "theta.h"
+#include "jps.h"
+#include "jpsplus.h"
+#include "searchkernel.h"
+#include "fixedpointastar.h"
+#include "bidirectional.h"
+#include "hpastar.h"
+#include "dstarlite.h"
+#include "arastar.h"
+#include "pathdatabase.h"
+#include "landmarks.h"
+#include "contraction.h"
 #include "gl_const.h"
+#include <algorithm>
 
 Mission::Mission()
 {
     search = nullptr;
     fileName = nullptr;
+    verbose = true;
+    componentCheck = false;
 }
 
 Mission::Mission(const char *FileName)
 {
     fileName = FileName;
     search = nullptr;
+    verbose = true;
+    componentCheck = false;
 }
 
 Mission::~Mission()
@@ -21,11 +37,82 @@ Mission::~Mission()
         delete search;
 }
 
-bool Mission::getMap(int startX, int startY, int endX, int endY, int cellSize, std::vector<std::vector<int>> &mapData)
+bool Mission::getMap(int startX, int startY, int endX, int endY, double cellSize, std::vector<std::vector<int>> &mapData)
 {
     return map.getMap(mapData, startX, startY, endX, endY, cellSize);
 }
 
+bool Mission::getMap(int startX, int startY, int endX, int endY, double cellSize, const signed char *mapData, int height, int width)
+{
+    return map.getMap(mapData, height, width, startX, startY, endX, endY, cellSize);
+}
+
+bool Mission::getMap(int startX, int startY, int endX, int endY, const Map &loaded)
+{
+    map = loaded;
+    return map.setEndpoints(startX, startY, endX, endY);
+}
+
+const ComponentLabels& Mission::useComponentLabels(double &buildTime)
+{
+    buildTime = 0;
+    std::shared_ptr<const ComponentLabels> labels = kept<ComponentLabels>();
+    if (!labels || !labels->fits(map, options)) {
+        labels = ComponentLabels::build(map, options.movementRules());
+        //The labels also serve the rules with the same connectivity
+        for (int k = 0; k < CN_MR_COUNT; k++)
+            if (ComponentLabels::diagonalFor(k) == labels->diagonal)
+                preprocessing.set(k, labels);
+        buildTime = labels->buildTime;
+    }
+    return *labels;
+}
+
+template <> std::shared_ptr<const HubLabels> Mission::buildPreprocessing<HubLabels>() const
+{
+    return HubLabels::build(map, options, 0, kept<ContractionHierarchy>());
+}
+
+template <> std::shared_ptr<const JumpTable> Mission::buildPreprocessing<JumpTable>() const
+{
+    return JPSPlus::preprocess(map, options);
+}
+
+void Mission::preprocess()
+{
+    double buildTime;
+    if (componentCheck)
+        useComponentLabels(buildTime);
+    //The same choices as createSearch: goal bounding comes before the landmarks
+    int type = static_cast<int>(config.SearchParams[CN_SP_ST]);
+    if (config.SearchParams[CN_SP_GB] && (type == CN_SP_ST_ASTAR || type == CN_SP_ST_JPS || type == CN_SP_ST_JPSPLUS))
+        usePreprocessing<GoalBounds>();
+    else if (config.SearchParams[CN_SP_LM] && type == CN_SP_ST_ASTAR) {
+        int count = std::max(1, std::min(static_cast<int>(config.SearchParams[CN_SP_LM]), CN_LM_MAX));
+        std::shared_ptr<const LandmarkTable> table = kept<LandmarkTable>();
+        if (!table || !table->fits(map, options, count))
+            preprocessing.set(options.movementRules(), LandmarkTable::build(map, options, count));
+    }
+    if (type == CN_SP_ST_JPSPLUS)
+        usePreprocessing<JumpTable>();
+    else if (type == CN_SP_ST_HPASTAR || type == CN_SP_ST_HPATHETA)
+        usePreprocessing<ClusterGraph>();
+    else if (type == CN_SP_ST_CPD)
+        usePreprocessing<PathDatabase>();
+    else if (type == CN_SP_ST_CH)
+        usePreprocessing<ContractionHierarchy>();
+    else if (type == CN_SP_ST_HL)
+        usePreprocessing<HubLabels>();
+    else if (type == CN_SP_ST_SUB)
+        usePreprocessing<SubgoalGraph>();
+}
+
+int Mission::getComponent(int i, int j)
+{
+    double buildTime;
+    return useComponentLabels(buildTime).label(i, j);
+}
+
 bool Mission::getConfig()
 {
     return config.getConfig(fileName);
@@ -40,6 +127,16 @@ bool Mission::setDefaultConfig(bool use_theta)
     return true;
 }
 
+bool Mission::setConfigParam(const std::string &tag, const std::string &value)
+{
+    return config.setParamByTag(tag, value);
+}
+
+bool Mission::limitsSupported() const
+{
+    return config.SearchParams[CN_SP_ST] != CN_SP_ST_DSL || (!config.SearchParams[CN_SP_EL] && !config.SearchParams[CN_SP_TL]);
+}
+
 void Mission::createEnvironmentOptions()
 {
     options = EnvironmentOptions(config.SearchParams[CN_SP_AS], config.SearchParams[CN_SP_AD],
@@ -48,33 +145,200 @@ void Mission::createEnvironmentOptions()
 
 void Mission::createSearch()
 {
+    //The search (and the buffers it has grown) is kept while the parameters it depends on stay the same
+    std::vector<double> settings = {config.SearchParams[CN_SP_ST], config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_MT],
+                                    config.SearchParams[CN_SP_BT], static_cast<double>(options.movementRules()),
+                                    config.SearchParams[CN_SP_FP], config.SearchParams[CN_SP_PAR], config.SearchParams[CN_SP_DL],
+                                    config.SearchParams[CN_SP_LM], config.SearchParams[CN_SP_GB]};
+    if (search && settings == searchSettings)
+        return;
+    searchSettings = settings;
     if (search)
         delete search;
+    search = nullptr;
     if (config.SearchParams[CN_SP_ST] == CN_SP_ST_ASTAR)
     {
-        std::cout << "Using A* search algorithm." << std::endl;
-        search = new Astar(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT]);
+        if (verbose)
+            std::cout << "Using A* search algorithm" << (config.SearchParams[CN_SP_GB] ? " with goal bounding." :
+                         config.SearchParams[CN_SP_LM] ? " with landmarks." : ".") << std::endl;
+        //The landmarks need the generic heuristic, the bucket OPEN list a consistent one, so weighted A* keeps the heap.
+        //The goal bounds prune the successors of the generic search
+        if (config.SearchParams[CN_SP_GB])
+            search = new GoalBoundedAstar(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT],
+                                          kept<GoalBounds>());
+        else if (config.SearchParams[CN_SP_LM])
+            search = new ALTAstar(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT],
+                                  config.SearchParams[CN_SP_LM], kept<LandmarkTable>());
+        else if (config.SearchParams[CN_SP_FP] && config.SearchParams[CN_SP_HW] == 1)
+            search = createFixedPointSearch(options.movementRules(), config.SearchParams[CN_SP_BT]);
+        else if (config.SearchParams[CN_SP_FP] && verbose)
+            std::cout << "Warning! '" << CNS_TAG_FP << "' is ignored when '" << CNS_TAG_HW << "' is not 1." << std::endl;
+        if (config.SearchParams[CN_SP_LM] && config.SearchParams[CN_SP_FP] && verbose)
+            std::cout << "Warning! '" << CNS_TAG_FP << "' is ignored with '" << CNS_TAG_LM << "'." << std::endl;
+        if (config.SearchParams[CN_SP_GB] && (config.SearchParams[CN_SP_LM] || config.SearchParams[CN_SP_FP]) && verbose)
+            std::cout << "Warning! '" << CNS_TAG_LM << "' and '" << CNS_TAG_FP << "' are ignored with '" << CNS_TAG_GB
+                      << "'." << std::endl;
+        if (!search)
+            search = createSearchKernel(CN_SP_ST_ASTAR, config.SearchParams[CN_SP_MT], options.movementRules(),
+                                        config.SearchParams[CN_SP_BT], config.SearchParams[CN_SP_HW]);
+        if (!search)
+            search = new Astar(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT]);
     }
     else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_TH)
     {
-        std::cout << "Using Theta* search algorithm." << std::endl;
-        search = new Theta(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT]);
+        if (verbose)
+            std::cout << "Using Theta* search algorithm." << std::endl;
+        search = createSearchKernel(CN_SP_ST_TH, config.SearchParams[CN_SP_MT], options.movementRules(),
+                                    config.SearchParams[CN_SP_BT], config.SearchParams[CN_SP_HW]);
+        if (!search)
+            search = new Theta(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT]);
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_LTH)
+    {
+        if (verbose)
+            std::cout << "Using Lazy Theta* search algorithm." << std::endl;
+        search = createSearchKernel(CN_SP_ST_LTH, config.SearchParams[CN_SP_MT], options.movementRules(),
+                                    config.SearchParams[CN_SP_BT], config.SearchParams[CN_SP_HW]);
+        //Only the kernel is lazy, the generic Theta* traces every line
+        if (!search) {
+            if (verbose)
+                std::cout << "Warning! Lazy Theta* does not support this metric and these movement rules, Theta* is used "
+                             "instead." << std::endl;
+            search = new Theta(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT]);
+        }
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_JPS)
+    {
+        if (verbose)
+            std::cout << "Using Jump Point Search algorithm" <<
+                         (config.SearchParams[CN_SP_GB] ? " with goal bounding." : ".") << std::endl;
+        search = new JPS(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT], config.SearchParams[CN_SP_GB],
+                         kept<GoalBounds>());
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_JPSPLUS)
+    {
+        if (verbose)
+            std::cout << "Using JPS+ search algorithm" <<
+                         (config.SearchParams[CN_SP_GB] ? " with goal bounding." : ".") << std::endl;
+        search = new JPSPlus(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT],
+                             kept<JumpTable>(), config.SearchParams[CN_SP_GB],
+                             kept<GoalBounds>());
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_BASTAR || config.SearchParams[CN_SP_ST] == CN_SP_ST_BDIJKSTRA)
+    {
+        bool dijkstra = (config.SearchParams[CN_SP_ST] == CN_SP_ST_BDIJKSTRA);
+        if (verbose)
+            std::cout << "Using bidirectional " << (dijkstra ? "Dijkstra" : "A*") << " search algorithm" <<
+                         (config.SearchParams[CN_SP_PAR] ? " on two threads." : ".") << std::endl;
+        search = new BidirectionalAstar(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT], dijkstra,
+                                        config.SearchParams[CN_SP_PAR]);
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_HPASTAR || config.SearchParams[CN_SP_ST] == CN_SP_ST_HPATHETA)
+    {
+        bool anyAngle = (config.SearchParams[CN_SP_ST] == CN_SP_ST_HPATHETA);
+        if (verbose)
+            std::cout << "Using HPA* search algorithm refined by " << (anyAngle ? "Theta*." : "A*.") << std::endl;
+        search = new HPAStar(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT], anyAngle,
+                             kept<ClusterGraph>());
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_DSL)
+    {
+        if (verbose)
+            std::cout << "Using D* Lite search algorithm." << std::endl;
+        search = new DStarLite();
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_ARA)
+    {
+        if (verbose)
+            std::cout << "Using ARA* search algorithm." << std::endl;
+        search = new ARAStar(config.SearchParams[CN_SP_HW], config.SearchParams[CN_SP_BT], config.SearchParams[CN_SP_DL]);
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_CPD)
+    {
+        if (verbose)
+            std::cout << "Using a compressed path database." << std::endl;
+        search = new CPDSearch(kept<PathDatabase>());
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_CH)
+    {
+        if (verbose)
+            std::cout << "Using a contraction hierarchy." << std::endl;
+        search = new CHSearch(kept<ContractionHierarchy>());
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_HL)
+    {
+        if (verbose)
+            std::cout << "Using hub labels." << std::endl;
+        search = new HLSearch(kept<HubLabels>(), kept<ContractionHierarchy>());
+    }
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_SUB)
+    {
+        if (verbose)
+            std::cout << "Using a subgoal graph." << std::endl;
+        search = new SubgoalSearch(kept<SubgoalGraph>());
     }
 }
 
 void Mission::startSearch()
 {
+    double buildTime = 0;
+    const ComponentLabels *labels = componentCheck ? &useComponentLabels(buildTime) : nullptr;
+    if (labels && !labels->connected(map.start_i, map.start_j, map.goal_i, map.goal_j)) {
+        sr = SearchResult();
+        sr.preprocessingtime = buildTime;
+        sr.preprocessingmemory = labels->memoryUsage();
+        return;
+    }
+    search->setLimits(static_cast<unsigned int>(config.SearchParams[CN_SP_EL]), config.SearchParams[CN_SP_TL]);
+    search->setDistanceOnly(config.SearchParams[CN_SP_DO]);
     sr = search->startSearch(map, options);
+    if (labels) {
+        sr.preprocessingtime += buildTime;
+        sr.preprocessingmemory += labels->memoryUsage();
+    }
+    if (config.SearchParams[CN_SP_ST] == CN_SP_ST_JPSPLUS)
+        preprocessing.set(options.movementRules(), static_cast<JPSPlus*>(search)->getJumpTable());
+    if (config.SearchParams[CN_SP_GB] && (config.SearchParams[CN_SP_ST] == CN_SP_ST_JPS ||
+                                          config.SearchParams[CN_SP_ST] == CN_SP_ST_JPSPLUS))
+        preprocessing.set(options.movementRules(), static_cast<JPS*>(search)->getGoalBounds());
+    else if (config.SearchParams[CN_SP_GB] && config.SearchParams[CN_SP_ST] == CN_SP_ST_ASTAR)
+        preprocessing.set(options.movementRules(), static_cast<GoalBoundedAstar*>(search)->getGoalBounds());
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_HPASTAR || config.SearchParams[CN_SP_ST] == CN_SP_ST_HPATHETA)
+        preprocessing.set(options.movementRules(), static_cast<HPAStar*>(search)->getClusterGraph());
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_CPD)
+        preprocessing.set(options.movementRules(), static_cast<CPDSearch*>(search)->getPathDatabase());
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_CH)
+        preprocessing.set(options.movementRules(), static_cast<CHSearch*>(search)->getContractionHierarchy());
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_HL)
+        preprocessing.set(options.movementRules(), static_cast<HLSearch*>(search)->getHubLabels());
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_SUB)
+        preprocessing.set(options.movementRules(), static_cast<SubgoalSearch*>(search)->getSubgoalGraph());
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_ASTAR && config.SearchParams[CN_SP_LM])
+        preprocessing.set(options.movementRules(), static_cast<ALTAstar*>(search)->getLandmarkTable());
     if (config.SearchParams[CN_SP_PS])
     {
         smooth_search_result(sr, map, options.cutcorners);
     }
 }
 
+std::unique_ptr<HierarchicalPath> Mission::planCoarse()
+{
+    double buildTime;
+    if (componentCheck && !useComponentLabels(buildTime).connected(map.start_i, map.start_j, map.goal_i, map.goal_j))
+        return nullptr;
+    bool anyAngle = (config.SearchParams[CN_SP_ST] == CN_SP_ST_TH || config.SearchParams[CN_SP_ST] == CN_SP_ST_LTH ||
+                     config.SearchParams[CN_SP_ST] == CN_SP_ST_HPATHETA);
+    std::unique_ptr<HierarchicalPath> path(new HierarchicalPath(map, options, config.SearchParams[CN_SP_HW],
+                                                                config.SearchParams[CN_SP_BT], anyAngle,
+                                                                kept<ClusterGraph>()));
+    preprocessing.set(options.movementRules(), path->getClusterGraph());
+    return path;
+}
+
 void Mission::getPath(std::vector<std::vector<int>> &path)
 {
     path.clear();
-    if (sr.pathfound) {
+    if (sr.pathfound || sr.partial) {
         std::list<Node> &srpath = *sr.lppath;
         for (std::list<Node>::const_iterator it = srpath.begin(); it != srpath.end(); it++) {
             std::vector<int> point;
@@ -103,13 +367,27 @@ void Mission::printSearchResultsToConsole()
     if (!sr.pathfound)
         std::cout << "NOT ";
     std::cout << "found!" << std::endl;
+    if (sr.partial)
+        std::cout << "Search stopped by a limit, the partial path ends at the expanded node closest to the goal." << std::endl;
     std::cout << "numberofsteps=" << sr.numberofsteps << std::endl;
+    if (sr.forwardsteps + sr.backwardsteps > 0) {
+        std::cout << "forwardsteps=" << sr.forwardsteps << std::endl;
+        std::cout << "backwardsteps=" << sr.backwardsteps << std::endl;
+    }
+    if (sr.lineofsightchecks > 0)
+        std::cout << "lineofsightchecks=" << sr.lineofsightchecks << std::endl;
+    if (sr.suboptimality > 0)
+        std::cout << "suboptimality=" << sr.suboptimality << std::endl;
     std::cout << "nodescreated=" << sr.nodescreated << std::endl;
-    if (sr.pathfound) {
+    if (sr.pathfound || sr.partial) {
         std::cout << "pathlength=" << sr.pathlength << std::endl;
         std::cout << "pathlength_scaled=" << sr.pathlength * map.cellSize << std::endl;
     }
     std::cout << "time=" << sr.time << std::endl;
+    if (sr.preprocessingmemory > 0) {
+        std::cout << "preprocessingtime=" << sr.preprocessingtime << std::endl;
+        std::cout << "preprocessingmemory=" << sr.preprocessingmemory << std::endl;
+    }
 }
 
 
@@ -119,6 +397,32 @@ const char *Mission::getAlgorithmName()
         return CNS_SP_ST_ASTAR;
     else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_TH)
         return CNS_SP_ST_TH;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_JPS)
+        return CNS_SP_ST_JPS;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_JPSPLUS)
+        return CNS_SP_ST_JPSPLUS;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_BASTAR)
+        return CNS_SP_ST_BASTAR;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_BDIJKSTRA)
+        return CNS_SP_ST_BDIJKSTRA;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_HPASTAR)
+        return CNS_SP_ST_HPASTAR;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_HPATHETA)
+        return CNS_SP_ST_HPATHETA;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_LTH)
+        return CNS_SP_ST_LTH;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_DSL)
+        return CNS_SP_ST_DSL;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_ARA)
+        return CNS_SP_ST_ARA;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_CPD)
+        return CNS_SP_ST_CPD;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_CH)
+        return CNS_SP_ST_CH;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_HL)
+        return CNS_SP_ST_HL;
+    else if (config.SearchParams[CN_SP_ST] == CN_SP_ST_SUB)
+        return CNS_SP_ST_SUB;
     else
         return "";
 }
@@ -3,7 +3,8 @@
 
 void smooth_search_result(SearchResult& sr, const Map &map, bool cutcorners)
 {
-    if(!sr.pathfound)
+    //A partial path may be the start cell alone
+    if((!sr.pathfound && !sr.partial) || sr.hppath->size() < 2)
     {
         return;
     }
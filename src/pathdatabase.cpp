@@ -0,0 +1,257 @@
+#include "pathdatabase.h"
+#include "firstmoves.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+const int CPDSearch::moves[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+
+PathDatabase::PathDatabase()
+{
+    height = 0;
+    width = 0;
+    movement = CN_MR_NOCORNER;
+    buildTime = 0;
+}
+
+bool PathDatabase::fits(const Map &map, const EnvironmentOptions &options) const
+{
+    return movement == options.movementRules() && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t PathDatabase::memoryUsage() const
+{
+    return rank.size() * sizeof(int32_t) + offsets.size() * sizeof(uint64_t) + runs.size() * sizeof(uint32_t) +
+           labels->memoryUsage();
+}
+
+int PathDatabase::firstMove(int i1, int j1, int i2, int j2) const
+{
+    if ((i1 == i2 && j1 == j2) || !labels->connected(i1, j1, i2, j2))
+        return -1;
+    int source = rank[static_cast<std::size_t>(i1) * width + j1], target = rank[static_cast<std::size_t>(i2) * width + j2];
+    const uint32_t *first = runs.data() + offsets[source], *last = runs.data() + offsets[source + 1];
+    //The last run that starts at or before the target, every source has a run starting at rank 0
+    const uint32_t *run = std::upper_bound(first, last, static_cast<uint32_t>(target) << 3 | 7) - 1;
+    return static_cast<int>(*run & 7);
+}
+
+//Position of the point (x, y) on the Hilbert curve through a side x side square (side is a power of two)
+static uint64_t hilbertIndex(int side, int x, int y)
+{
+    uint64_t index = 0;
+    for (int s = side / 2; s > 0; s /= 2) {
+        int rx = (x & s) > 0, ry = (y & s) > 0;
+        index += static_cast<uint64_t>(s) * s * ((3 * rx) ^ ry);
+        if (ry == 0) {
+            if (rx == 1) {
+                x = side - 1 - x;
+                y = side - 1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+void PathDatabase::rankCells(std::vector<int> &cells)
+{
+    int side = 1;
+    while (side < std::max(height, width))
+        side <<= 1;
+    std::vector<std::pair<uint64_t, int>> keys;
+    for (int i = 0; i < height; i++)
+        for (int j = 0; j < width; j++)
+            if (!grid->isObstacle(i, j))
+                keys.push_back(std::make_pair(hilbertIndex(side, j, i), i * width + j));
+    std::sort(keys.begin(), keys.end());
+    rank.assign(static_cast<std::size_t>(height) * width, -1);
+    cells.resize(keys.size());
+    for (std::size_t r = 0; r < keys.size(); r++) {
+        cells[r] = keys[r].second;
+        rank[keys[r].second] = static_cast<int32_t>(r);
+    }
+}
+
+//Cuts the targets (in rank order) into the fewest runs whose first move sets have a move in common
+static void compress(const std::vector<uint8_t> &mask, std::vector<uint32_t> &runs)
+{
+    runs.clear();
+    uint32_t begin = 0;
+    unsigned int common = 0xFF;
+    for (std::size_t r = 0; r < mask.size(); r++) {
+        unsigned int moves = mask[r];
+        if (!moves)
+            moves = 0xFF;//the source itself and the targets it cannot reach
+        if (common & moves)
+            common &= moves;
+        else {
+            runs.push_back(begin << 3 | lowestBit(common));
+            begin = static_cast<uint32_t>(r);
+            common = moves;
+        }
+    }
+    runs.push_back(begin << 3 | lowestBit(common));
+}
+
+std::shared_ptr<const PathDatabase> PathDatabase::build(const Map &map, const EnvironmentOptions &options, int threads)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<PathDatabase> result = std::make_shared<PathDatabase>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = options.movementRules();
+    result->grid = map.getSharedGrid();
+    result->labels = ComponentLabels::build(map, result->movement);
+    std::vector<int> cells;
+    result->rankCells(cells);
+
+    std::vector<int> first;
+    std::vector<uint32_t> edges;
+    linkCells(map, result->movement, cells, result->rank, first, edges);
+
+    //Every source writes its own runs, they are joined in rank order afterwards
+    std::vector<std::vector<uint32_t>> sourceRuns(cells.size());
+    ThreadPool pool(threads);
+    std::vector<FirstMoveBuffers> buffers(pool.size());
+    pool.run(static_cast<int>(cells.size()), [&](int worker, int r) {
+        firstMoves(first, edges, r, buffers[worker]);
+        compress(buffers[worker].mask, sourceRuns[r]);
+    });
+    result->offsets.resize(cells.size() + 1, 0);
+    for (std::size_t r = 0; r < cells.size(); r++)
+        result->offsets[r + 1] = result->offsets[r] + sourceRuns[r].size();
+    result->runs.reserve(result->offsets.back());
+    for (std::size_t r = 0; r < cells.size(); r++) {
+        result->runs.insert(result->runs.end(), sourceRuns[r].begin(), sourceRuns[r].end());
+        std::vector<uint32_t>().swap(sourceRuns[r]);
+    }
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+static const char cpdMagic[4] = {'C', 'P', 'D', 'B'};
+
+bool PathDatabase::save(const std::string &fileName) const
+{
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    int32_t header[4] = {CN_CPD_VERSION, height, width, movement};
+    uint64_t sizes[3] = {grid->fingerprint(), offsets.size() - 1, runs.size()};
+    file.write(cpdMagic, sizeof(cpdMagic));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+    //The ranks follow from the grid and the labels are cheap to rebuild, so only the runs are written
+    file.write(reinterpret_cast<const char *>(offsets.data()), offsets.size() * sizeof(uint64_t));
+    file.write(reinterpret_cast<const char *>(runs.data()), runs.size() * sizeof(uint32_t));
+    file.close();
+    return !file.fail();
+}
+
+std::shared_ptr<const PathDatabase> PathDatabase::load(const std::string &fileName, const Map &map)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    char magic[4];
+    int32_t header[4];
+    uint64_t sizes[3];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    file.read(reinterpret_cast<char *>(sizes), sizeof(sizes));
+    if (!file || memcmp(magic, cpdMagic, sizeof(magic)) != 0 || header[0] != CN_CPD_VERSION ||
+            header[1] != map.height || header[2] != map.width || header[3] < 0 || header[3] >= CN_MR_COUNT ||
+            sizes[0] != map.getGrid().fingerprint())
+        return nullptr;
+
+    std::shared_ptr<PathDatabase> result = std::make_shared<PathDatabase>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = header[3];
+    result->grid = map.getSharedGrid();
+    std::vector<int> cells;
+    result->rankCells(cells);
+    if (sizes[1] != cells.size() || sizes[2] >= (uint64_t(1) << 40))
+        return nullptr;
+    result->offsets.resize(cells.size() + 1);
+    result->runs.resize(sizes[2]);
+    file.read(reinterpret_cast<char *>(result->offsets.data()), result->offsets.size() * sizeof(uint64_t));
+    file.read(reinterpret_cast<char *>(result->runs.data()), result->runs.size() * sizeof(uint32_t));
+    if (!file || result->offsets[0] != 0 || result->offsets.back() != result->runs.size())
+        return nullptr;
+    //firstMove relies on every source having runs and the first of them starting at rank 0
+    for (std::size_t r = 0; r < cells.size(); r++)
+        if (result->offsets[r] >= result->offsets[r + 1] || (result->runs[result->offsets[r]] >> 3) != 0)
+            return nullptr;
+    result->labels = ComponentLabels::build(map, result->movement);
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+CPDSearch::CPDSearch(std::shared_ptr<const PathDatabase> database):Astar(1, CN_SP_BT_GMAX)
+{
+    this->database = database;
+}
+
+SearchResult CPDSearch::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    if (!database || !database->fits(map, options)) {
+        database = PathDatabase::build(map, options);
+        sresult.preprocessingtime = database->buildTime;
+    }
+    sresult.preprocessingmemory = database->memoryUsage();
+
+    Node curNode;
+    curNode.i = map.start_i;
+    curNode.j = map.start_j;
+    curNode.g = 0;
+    curNode.H = 0;
+    curNode.F = 0;
+    curNode.parent = -1;
+    if (!distanceonly)
+        lppath.push_back(curNode);
+    bool pathfound = (curNode.i == map.goal_i && curNode.j == map.goal_j);
+    //An optimal path visits every free cell at most once, which also bounds the walk on a damaged database
+    std::size_t length = 1, maxLength = database->offsets.size();
+    while (!pathfound && length < maxLength) {
+        int k = database->firstMove(curNode.i, curNode.j, map.goal_i, map.goal_j);
+        if (k < 0 || !map.CellIsTraversable(curNode.i + moves[k][0], curNode.j + moves[k][1]))
+            break;
+        curNode.parent = curNode.i * map.width + curNode.j;
+        curNode.i += moves[k][0];
+        curNode.j += moves[k][1];
+        curNode.g += (moves[k][0] != 0 && moves[k][1] != 0) ? sqrt(2) : 1;
+        curNode.F = curNode.g;
+        if (!distanceonly)
+            lppath.push_back(curNode);
+        length++;
+        pathfound = (curNode.i == map.goal_i && curNode.j == map.goal_j);
+    }
+    sresult.numberofsteps = static_cast<unsigned int>(length - 1);
+    sresult.nodescreated = static_cast<unsigned int>(length);
+    if (pathfound) {
+        sresult.pathfound = true;
+        sresult.pathlength = curNode.g;
+    }
+    else
+        lppath.clear();
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
+    sresult.time -= sresult.preprocessingtime;
+    if (pathfound && !distanceonly)
+        makeSecondaryPath();
+
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
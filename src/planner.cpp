@@ -0,0 +1,283 @@
+#include "planner.h"
+#include "threadpool.h"
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <algorithm>
+#include <exception>
+
+Planner::Planner(const std::vector<float> &origin, const std::vector<int> &dim, const signed char *map, std::size_t map_size, double resolution)
+{
+    loaded = false;
+    componentCheck = true;
+    origin_x = origin.size() > 0 ? origin[0] : 0;
+    origin_y = origin.size() > 1 ? origin[1] : 0;
+    this->resolution = resolution;
+    if (origin.size() < 2 || dim.size() < 2 || resolution <= 0)
+        return;
+    int width = dim[0], height = dim[1];
+    if (height <= 0 || width <= 0 || map_size < static_cast<std::size_t>(height) * width)
+        return;
+    loaded = this->map.loadGrid(map, height, width, resolution);
+}
+
+bool Planner::isValidOption(const std::string &tag, const std::string &value)
+{
+    Config config;
+    return config.setParamByTag(tag, value);
+}
+
+bool Planner::setOption(const std::string &tag, const std::string &value)
+{
+    if (!isValidOption(tag, value))
+        return false;
+    std::lock_guard<std::mutex> lock(mutex);
+    defaults[tag] = value;
+    return true;
+}
+
+void Planner::setComponentCheck(bool check)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    componentCheck = check;
+}
+
+std::unique_ptr<Mission> Planner::acquire(Options &defaults)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<Mission> mission;
+    if (!idle.empty()) {
+        mission = std::move(idle.back());
+        idle.pop_back();
+    }
+    else {
+        mission.reset(new Mission());
+        mission->setVerbose(false);
+    }
+    mission->setPreprocessing(preprocessing);
+    mission->setComponentCheck(componentCheck);
+    defaults = this->defaults;
+    return mission;
+}
+
+void Planner::release(std::unique_ptr<Mission> mission)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    //Tables built by this query become available to the other Missions
+    preprocessing.merge(mission->getPreprocessing(), false);
+    idle.push_back(std::move(mission));
+}
+
+bool Planner::toCell(const std::vector<float> &point, int &x, int &y) const
+{
+    if (point.size() < 2)
+        return false;
+    double cx = std::floor((point[0] - origin_x) / resolution);
+    double cy = std::floor((point[1] - origin_y) / resolution);
+    if (cx < 0 || cx >= map.width || cy < 0 || cy >= map.height)
+        return false;
+    x = static_cast<int>(cx);
+    y = static_cast<int>(cy);
+    return true;
+}
+
+int Planner::plan(const std::vector<float> &start, const std::vector<float> &goal, const Options &options,
+                  std::vector<double> &path, double &time_spent)
+{
+    Result result;
+    plan(start, goal, options, result);
+    path.swap(result.path);
+    time_spent = result.time;
+    return result.status;
+}
+
+int Planner::plan(const std::vector<float> &start, const std::vector<float> &goal, const Options &options, Result &result)
+{
+    result = Result();
+    if (!loaded)
+        return -1;
+    Options defaults;
+    std::unique_ptr<Mission> mission = acquire(defaults);
+    plan(*mission, defaults, start, goal, options, result);
+    release(std::move(mission));
+    return result.status;
+}
+
+bool Planner::setUp(Mission &mission, const Options &defaults, const std::vector<float> &start, const std::vector<float> &goal,
+                    const Options &options)
+{
+    int start_x, start_y, goal_x, goal_y;
+    if (!toCell(start, start_x, start_y) || !toCell(goal, goal_x, goal_y))
+        return false; // Invalid start or goal position
+    if (!mission.getMap(start_x, start_y, goal_x, goal_y, map))
+        return false; // Start or goal is blocked
+    return configure(mission, defaults, options);
+}
+
+bool Planner::configure(Mission &mission, const Options &defaults, const Options &options)
+{
+    mission.setDefaultConfig(false);
+    for (Options::const_iterator it = defaults.begin(); it != defaults.end(); ++it)
+        mission.setConfigParam(it->first, it->second);
+    for (Options::const_iterator it = options.begin(); it != options.end(); ++it)
+        if (!mission.setConfigParam(it->first, it->second))
+            return false; // Unknown option
+    if (!mission.limitsSupported())
+        return false;
+    mission.createEnvironmentOptions();
+    return true;
+}
+
+int Planner::plan(Mission &mission, const Options &defaults, const std::vector<float> &start, const std::vector<float> &goal,
+                  const Options &options, Result &result)
+{
+    result = Result();
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    if (!setUp(mission, defaults, start, goal, options))
+        return -1;
+    mission.createSearch();
+    mission.startSearch();
+    result.time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::vector<std::vector<int>> cells;
+    mission.getPath(cells);
+    result.path.reserve(cells.size() * 2);
+    for (std::size_t k = 0; k < cells.size(); k++) {
+        result.path.push_back(origin_x + cells[k][0] * resolution);
+        result.path.push_back(origin_y + cells[k][1] * resolution);
+    }
+    result.suboptimality = mission.getSuboptimality();
+    result.expansions = mission.getExpansions();
+    result.length = mission.getPathLength() * resolution;
+    result.status = mission.getPathValid() ? 0 : (mission.getPathPartial() ? 1 : -1);
+    return result.status;
+}
+
+void Planner::planBatch(const std::vector<Query> &queries, const Options &options, std::vector<Result> &results, int threads)
+{
+    results.assign(queries.size(), Result());
+    if (!loaded || queries.empty())
+        return;
+    ThreadPool pool(std::min(threads > 0 ? threads : static_cast<int>(std::thread::hardware_concurrency()),
+                             static_cast<int>(queries.size())));
+    //Every worker keeps one Mission (and so one set of search buffers) for the whole batch
+    std::vector<std::unique_ptr<Mission>> missions(pool.size());
+    Options defaults;
+    //The tables the options need are built once, on all cores, before the workers start
+    std::unique_ptr<Mission> builder = acquire(defaults);
+    builder->getMap(map);
+    if (configure(*builder, defaults, options))
+        builder->preprocess();
+    release(std::move(builder));
+    for (int k = 0; k < pool.size(); k++)
+        missions[k] = acquire(defaults);
+    std::exception_ptr error;
+    try {
+        pool.run(static_cast<int>(queries.size()), [&](int worker, int index) {
+            plan(*missions[worker], defaults, queries[index].start, queries[index].goal, options, results[index]);
+        });
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+    for (int k = 0; k < pool.size(); k++)
+        release(std::move(missions[k]));
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void Planner::expansionReport(const std::vector<Query> &queries, const Options &options,
+                              std::vector<std::pair<int, int>> &expansions, int threads)
+{
+    Options without = options;
+    without[CNS_TAG_LM] = "0";
+    std::vector<Result> before, after;
+    planBatch(queries, without, before, threads);
+    planBatch(queries, options, after, threads);
+    expansions.resize(queries.size());
+    for (std::size_t k = 0; k < queries.size(); k++)
+        expansions[k] = std::make_pair(before[k].expansions, after[k].expansions);
+}
+
+void Planner::distances(const std::vector<Query> &queries, const Options &options, std::vector<double> &lengths,
+                        int threads)
+{
+    Options distanceOnly = options;
+    distanceOnly[CNS_TAG_DO] = "true";
+    std::vector<Result> results;
+    planBatch(queries, distanceOnly, results, threads);
+    lengths.resize(queries.size());
+    for (std::size_t k = 0; k < queries.size(); k++)
+        lengths[k] = results[k].status == 0 ? results[k].length : -1;
+}
+
+int Planner::planCoarse(const std::vector<float> &start, const std::vector<float> &goal, const Options &options,
+                        std::unique_ptr<CoarsePath> &path, double &time_spent)
+{
+    path.reset();
+    time_spent = 0;
+    if (!loaded)
+        return -1;
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    Options defaults;
+    std::unique_ptr<Mission> mission = acquire(defaults);
+    if (setUp(*mission, defaults, start, goal, options)) {
+        std::unique_ptr<HierarchicalPath> coarse = mission->planCoarse();
+        if (coarse && coarse->found())
+            path.reset(new CoarsePath(std::move(coarse), origin_x, origin_y, resolution));
+    }
+    release(std::move(mission));
+    time_spent = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    return path ? 0 : -1;
+}
+
+void Planner::CoarsePath::waypoints(std::vector<double> &points) const
+{
+    points.clear();
+    for (int k = 0; k <= path->segments(); k++) {
+        points.push_back(origin_x + path->waypointJ(k) * resolution);
+        points.push_back(origin_y + path->waypointI(k) * resolution);
+    }
+}
+
+bool Planner::CoarsePath::refine(int k, std::vector<double> &points)
+{
+    points.clear();
+    std::list<Node> cells;
+    if (!path->refine(k, cells))
+        return false;
+    points.reserve(cells.size() * 2);
+    for (std::list<Node>::const_iterator it = cells.begin(); it != cells.end(); ++it) {
+        points.push_back(origin_x + it->j * resolution);
+        points.push_back(origin_y + it->i * resolution);
+    }
+    return true;
+}
+
+int Planner::component(const std::vector<float> &point, const Options &options)
+{
+    std::vector<int> ids;
+    components(point, options, ids);
+    return ids.empty() ? -1 : ids[0];
+}
+
+void Planner::components(const std::vector<float> &points, const Options &options, std::vector<int> &ids)
+{
+    ids.assign(points.size() / 2, -1);
+    if (!loaded || ids.empty())
+        return;
+    Options defaults;
+    std::unique_ptr<Mission> mission = acquire(defaults);
+    mission->getMap(map);
+    if (configure(*mission, defaults, options)) {
+        std::vector<float> point(2);
+        for (std::size_t k = 0; k < ids.size(); k++) {
+            int x, y;
+            point[0] = points[2 * k];
+            point[1] = points[2 * k + 1];
+            if (toCell(point, x, y))
+                ids[k] = mission->getComponent(y, x);
+        }
+    }
+    release(std::move(mission));
+}
@@ -1,26 +1,119 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h> // For automatic conversion of std::vector
+#include <pybind11/numpy.h>
 #include "wrapper.h"     // Contains the declaration of plan_2d
+#include "planner.h"
+#include "replanner.h"
+#include "gl_const.h"
 #include <tuple>         // For std::tuple
 
 namespace py = pybind11;
 
+// Returns map_data as a C-contiguous array of one-byte cells. Such arrays (int8, uint8, bool) are returned
+// as they are, so the planner reads the caller's memory; anything else (lists, other dtypes, strided views)
+// is converted once to int8 with every non-zero cell marked as an obstacle.
+static py::array cellArray(const py::object &map_data)
+{
+    py::array cells = py::array::ensure(map_data);
+    if (!cells)
+        throw py::type_error("map_data must be a sequence or an array of cells");
+    if (cells.itemsize() != 1 || !(cells.flags() & py::array::c_style))
+        cells = py::array_t<signed char, py::array::c_style | py::array::forcecast>::ensure(cells.attr("__ne__")(0));
+    return cells;
+}
+
+// Wraps the (x, y) pairs into an (N, 2) float64 array that takes over the vector without copying it
+static py::array_t<double> pathArray(std::vector<double> &&points)
+{
+    std::vector<double> *storage = new std::vector<double>(std::move(points));
+    py::capsule owner(storage, [](void *p) { delete static_cast<std::vector<double> *>(p); });
+    py::ssize_t n = static_cast<py::ssize_t>(storage->size() / 2);
+    return py::array_t<double>({n, py::ssize_t(2)}, storage->data(), owner);
+}
+
+// Pairs start[k] -> goal[k] from two (N, 2) arrays (or lists of [x, y])
+static std::vector<Planner::Query> toQueries(const py::object &starts, const py::object &goals)
+{
+    typedef py::array_t<float, py::array::c_style | py::array::forcecast> Points;
+    Points s = Points::ensure(starts), g = Points::ensure(goals);
+    if (!s || !g || s.ndim() != 2 || g.ndim() != 2 || s.shape(1) != 2 || g.shape(1) != 2 || s.shape(0) != g.shape(0))
+        throw py::value_error("starts and goals must be (N, 2) arrays of the same length");
+    std::vector<Planner::Query> queries(static_cast<std::size_t>(s.shape(0)));
+    for (std::size_t k = 0; k < queries.size(); k++) {
+        queries[k].start.assign(s.data(k, 0), s.data(k, 0) + 2);
+        queries[k].goal.assign(g.data(k, 0), g.data(k, 0) + 2);
+    }
+    return queries;
+}
+
+// Flattens an (N, 2) array (or list of [x, y]) to x0, y0, x1, y1, ...
+static std::vector<float> toPoints(const py::object &points)
+{
+    typedef py::array_t<float, py::array::c_style | py::array::forcecast> Points;
+    Points p = Points::ensure(points);
+    if (!p || p.ndim() != 2 || p.shape(1) != 2)
+        throw py::value_error("points must be an (N, 2) array");
+    return std::vector<float>(p.data(), p.data() + p.size());
+}
+
+// Plans the whole batch without the GIL and converts the results (in input order) to (status, path, time) tuples
+static py::list planMany(Planner &planner, const std::vector<Planner::Query> &queries, const Planner::Options &options, int threads)
+{
+    std::vector<Planner::Result> results;
+    {
+        py::gil_scoped_release release;
+        planner.planBatch(queries, options, results, threads);
+    }
+    py::list answers;
+    for (std::size_t k = 0; k < results.size(); k++)
+        answers.append(py::make_tuple(results[k].status, pathArray(std::move(results[k].path)), results[k].time));
+    return answers;
+}
+
+// Keyword arguments as config tags and values, e.g. searchtype="jps", hweight=1.5, cutcorners=True
+static Planner::Options toOptions(const py::kwargs &kwargs)
+{
+    Planner::Options options;
+    for (auto item : kwargs) {
+        std::string tag = py::str(item.first);
+        std::string value = py::isinstance<py::bool_>(item.second) ? (item.second.cast<bool>() ? "true" : "false")
+                                                                    : std::string(py::str(item.second));
+        if (!Planner::isValidOption(tag, value))
+            throw py::value_error("invalid option " + tag + "=" + value);
+        options[tag] = value;
+    }
+    return options;
+}
+
 PYBIND11_MODULE(ThetaStarPlanner, m) {
     m.doc() = R"pbdoc(
-        Python module for A* and Theta* path planning
-        ---------------------------------------------
+        Python module for A*, Theta* and JPS path planning
+        -------------------------------------------------
         .. currentmodule:: ThetaStarPlanner
         .. autosummary::
            :toctree: _generate
            plan_2d
+           plan_many
+           Planner
+           CoarsePath
+           Replanner
     )pbdoc";
 
     m.def("plan_2d",
-          [](std::vector<float> &origin, std::vector<int> &dim, std::vector<signed char> &map_data, std::vector<float> &start, std::vector<float> &goal, float resolution, bool use_theta) {
-              std::vector<std::vector<double>> path;
+          [](const std::vector<float> &origin, const std::vector<int> &dim, const py::object &map_data, const std::vector<float> &start, const std::vector<float> &goal, double resolution, bool use_theta, const std::string &searchtype, const py::kwargs &kwargs) {
+              Planner::Options options = toOptions(kwargs);
+              py::array cells = cellArray(map_data);
+              std::vector<double> path;
               double time_spent = 0.0;
-              int status = ::plan_2d(origin, dim, map_data, start, goal, resolution, path, time_spent, use_theta);
-              return std::make_tuple(status, path, time_spent);
+              int status;
+              {
+                  // The search only touches C++ data, other Python threads can run meanwhile
+                  py::gil_scoped_release release;
+                  status = ::plan_2d(origin, dim, static_cast<const signed char *>(cells.data()), static_cast<std::size_t>(cells.size()),
+                                     start, goal, resolution, path, time_spent,
+                                     searchtype.empty() ? std::string(use_theta ? CNS_SP_ST_TH : CNS_SP_ST_ASTAR) : searchtype, options);
+              }
+              return std::make_tuple(status, pathArray(std::move(path)), time_spent);
           },
           py::arg("origin"),
           py::arg("dim"),
@@ -29,27 +122,519 @@ PYBIND11_MODULE(ThetaStarPlanner, m) {
           py::arg("goal"),
           py::arg("resolution"),
           py::arg("use_theta"),
+          py::arg("searchtype") = "",
           R"pbdoc(
-            Plans a 2D path using A* or Theta* algorithm.
+            Plans a 2D path using A*, Theta*, Jump Point Search, JPS+ or a bidirectional search.
+            The GIL is released while planning; map_data must not be modified by other threads meanwhile.
 
             Args:
                 origin (list[float]): Origin of the map [x, y] in meters.
-                dim (list[int]): Dimensions of the map [height, width] in grid cells.
-                map_data (list[int]): Map data as a flattened list (row-major). 0 for free, 1 for obstacle.
-                                     Note: C++ expects signed char, Python will pass integers.
+                dim (list[int]): Dimensions of the map [width, height] in grid cells.
+                map_data (numpy.ndarray or list[int]): Map cells in row-major order (flat or height x width),
+                                     0 for free, any other value for obstacle. A C-contiguous int8, uint8 or
+                                     bool array is read in place without copying.
                 start (list[float]): Start coordinates [x, y] in meters.
                 goal (list[float]): Goal coordinates [x, y] in meters.
                 resolution (float): Map resolution in meters/cell.
                 use_theta (bool): If true, uses Theta*; otherwise, uses A*.
+                searchtype (str): Optional algorithm name, overrides use_theta: "astar", "theta", "lazytheta", "jps",
+                                  "jpsplus", "bastar", "bdijkstra", "hpastar", "hpatheta", "dstarlite", "arastar",
+                                  "cpd", "ch", "hl" or "subgoal" (the CNS_SP_ST_* names of gl_const.h).
+                **options: Further config tags, e.g. parallel=True to run the two directions of "bastar" or
+                           "bdijkstra" on two threads, deadline=20 (milliseconds) for "arastar", or maxexpansions=5000
+                           and maxtime=2 (milliseconds) to stop the search early with a partial path.
 
             Returns:
-                tuple[int, list[list[float]], float]: A tuple containing:
-                    - status (int): 0 if successful, -1 otherwise.
-                    - path (list[list[float]]): The calculated path, a list of [x,y] coordinates.
+                tuple[int, numpy.ndarray, float]: A tuple containing:
+                    - status (int): 0 if successful, 1 if maxexpansions or maxtime stopped the search (the path
+                      then leads to the expanded cell closest to the goal), -1 otherwise.
+                    - path (numpy.ndarray): The calculated path, an (N, 2) float64 array of [x, y] coordinates.
                     - time_spent (float): The time spent in planning (in milliseconds).
           )pbdoc"
     );
 
+    m.def("plan_many",
+          [](const std::vector<float> &origin, const std::vector<int> &dim, const py::object &map_data, double resolution,
+             const py::object &starts, const py::object &goals, int threads, const py::kwargs &kwargs) {
+              py::array cells = cellArray(map_data);
+              std::vector<Planner::Query> queries = toQueries(starts, goals);
+              Planner::Options options = toOptions(kwargs);
+              std::unique_ptr<Planner> planner;
+              {
+                  py::gil_scoped_release release;
+                  planner.reset(new Planner(origin, dim, static_cast<const signed char *>(cells.data()),
+                                            static_cast<std::size_t>(cells.size()), resolution));
+              }
+              if (!planner->isLoaded())
+                  throw py::value_error("map_data does not match dim, or origin, dim or resolution is malformed");
+              return planMany(*planner, queries, options, threads);
+          },
+          py::arg("origin"),
+          py::arg("dim"),
+          py::arg("map_data"),
+          py::arg("resolution"),
+          py::arg("starts"),
+          py::arg("goals"),
+          py::arg("threads") = 0,
+          R"pbdoc(
+            Plans from starts[k] to goals[k] for every k on one map, spread over a work-stealing thread pool.
+
+            Args:
+                origin, dim, map_data, resolution: As for plan_2d.
+                starts, goals (numpy.ndarray): (N, 2) arrays of [x, y] points in meters.
+                threads (int): Number of worker threads, 0 for one per hardware thread.
+                Keyword arguments are options for all queries (searchtype, hweight, cutcorners, ...).
+
+            Returns:
+                list[tuple[int, numpy.ndarray, float]]: (status, path, time_spent) of every query, in input order.
+          )pbdoc"
+    );
+
+    py::class_<Planner>(m, "Planner", R"pbdoc(
+            Keeps a map loaded for many queries. The map is packed once (the array passed in is not kept),
+            and the search, its buffers and any preprocessing (e.g. the JPS+ jump table) are reused,
+            so every query only pays for the search itself. plan() releases the GIL and may be called
+            from several threads at once.
+          )pbdoc")
+        .def(py::init([](const std::vector<float> &origin, const std::vector<int> &dim, const py::object &map_data, double resolution, const py::kwargs &kwargs) {
+                 py::array cells = cellArray(map_data);
+                 std::unique_ptr<Planner> planner;
+                 {
+                     py::gil_scoped_release release;
+                     planner.reset(new Planner(origin, dim, static_cast<const signed char *>(cells.data()),
+                                               static_cast<std::size_t>(cells.size()), resolution));
+                 }
+                 if (!planner->isLoaded())
+                     throw py::value_error("map_data does not match dim, or origin, dim or resolution is malformed");
+                 Planner::Options options = toOptions(kwargs);
+                 for (Planner::Options::const_iterator it = options.begin(); it != options.end(); ++it)
+                     planner->setOption(it->first, it->second);
+                 return planner;
+             }),
+             py::arg("origin"),
+             py::arg("dim"),
+             py::arg("map_data"),
+             py::arg("resolution"),
+             R"pbdoc(
+            Args are the same as for plan_2d. Keyword arguments set default options for all queries:
+            searchtype, hweight, metrictype, breakingties, allowdiagonal, cutcorners, allowsqueeze, postsmoothing,
+            fixedpoint, parallel, deadline, maxexpansions, maxtime, landmarks, distanceonly and goalbounding (the
+            CNS_TAG_* tags of gl_const.h).
+          )pbdoc")
+        .def("plan",
+             [](Planner &self, const std::vector<float> &start, const std::vector<float> &goal, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 std::vector<double> path;
+                 double time_spent = 0.0;
+                 int status;
+                 {
+                     py::gil_scoped_release release;
+                     status = self.plan(start, goal, options, path, time_spent);
+                 }
+                 return std::make_tuple(status, pathArray(std::move(path)), time_spent);
+             },
+             py::arg("start"),
+             py::arg("goal"),
+             R"pbdoc(
+            Plans from start to goal ([x, y] in meters). Keyword arguments override the default options
+            for this query only, e.g. planner.plan(start, goal, searchtype="jps").
+
+            Returns:
+                tuple[int, numpy.ndarray, float]: status (0 if a path was found, 1 for a partial path as in plan_2d,
+                -1 otherwise), the (N, 2) float64 path and the planning time in milliseconds.
+          )pbdoc")
+        .def("plan_anytime",
+             [](Planner &self, const std::vector<float> &start, const std::vector<float> &goal, double deadline, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 options[CNS_TAG_ST] = CNS_SP_ST_ARA;
+                 options[CNS_TAG_DL] = std::to_string(deadline);
+                 Planner::Result result;
+                 {
+                     py::gil_scoped_release release;
+                     self.plan(start, goal, options, result);
+                 }
+                 return std::make_tuple(result.status, pathArray(std::move(result.path)), result.time, result.suboptimality);
+             },
+             py::arg("start"),
+             py::arg("goal"),
+             py::arg("deadline"),
+             R"pbdoc(
+            Plans with ARA*: a first path is found with a high weight (hweight, 3 if it is 1) and improved with lower
+            weights until it is optimal or deadline milliseconds have passed (0 = until it is optimal). The first path
+            is always completed, so a slow first search can overrun the deadline. Same as plan() with
+            searchtype="arastar" and deadline=..., which plan_2d also accepts.
+
+            Returns:
+                tuple[int, numpy.ndarray, float, float]: status, path and time as for plan(), and the suboptimality
+                bound of the path (its length is at most bound times the optimal one).
+          )pbdoc")
+        .def("plan_many",
+             [](Planner &self, const py::object &starts, const py::object &goals, int threads, const py::kwargs &kwargs) {
+                 std::vector<Planner::Query> queries = toQueries(starts, goals);
+                 return planMany(self, queries, toOptions(kwargs), threads);
+             },
+             py::arg("starts"),
+             py::arg("goals"),
+             py::arg("threads") = 0,
+             R"pbdoc(
+            Plans from starts[k] to goals[k] ((N, 2) arrays of [x, y] in meters) for every k on a work-stealing
+            thread pool with threads workers (0 = one per hardware thread). Keyword arguments override the default
+            options for this batch. Returns the (status, path, time_spent) tuples in input order.
+          )pbdoc")
+        .def("expansion_report",
+             [](Planner &self, const py::object &starts, const py::object &goals, int threads, const py::kwargs &kwargs) {
+                 std::vector<Planner::Query> queries = toQueries(starts, goals);
+                 Planner::Options options = toOptions(kwargs);
+                 std::vector<std::pair<int, int>> expansions;
+                 {
+                     py::gil_scoped_release release;
+                     self.expansionReport(queries, options, expansions, threads);
+                 }
+                 py::array_t<int> result({static_cast<py::ssize_t>(expansions.size()), py::ssize_t(2)});
+                 for (std::size_t k = 0; k < expansions.size(); k++) {
+                     result.mutable_at(k, 0) = expansions[k].first;
+                     result.mutable_at(k, 1) = expansions[k].second;
+                 }
+                 return result;
+             },
+             py::arg("starts"),
+             py::arg("goals"),
+             py::arg("threads") = 0,
+             R"pbdoc(
+            Plans the queries of plan_many() twice, without landmarks and with the keyword arguments
+            (e.g. landmarks=16), and returns an (N, 2) int array of the nodes expanded by each query
+            [without, with]. Queries that fail at once count 0.
+          )pbdoc")
+        .def("distances",
+             [](Planner &self, const py::object &starts, const py::object &goals, int threads, const py::kwargs &kwargs) {
+                 std::vector<Planner::Query> queries = toQueries(starts, goals);
+                 Planner::Options options = toOptions(kwargs);
+                 std::vector<double> lengths;
+                 {
+                     py::gil_scoped_release release;
+                     self.distances(queries, options, lengths, threads);
+                 }
+                 py::array_t<double> result(static_cast<py::ssize_t>(lengths.size()));
+                 std::copy(lengths.begin(), lengths.end(), result.mutable_data());
+                 return result;
+             },
+             py::arg("starts"),
+             py::arg("goals"),
+             py::arg("threads") = 0,
+             R"pbdoc(
+            Lengths in meters of shortest paths for the queries of plan_many(), -1.0 where there is none, as a
+            float64 array. The searches run with distanceonly=True and build no paths; with searchtype="hl" a
+            query is one merge of two hub labels.
+          )pbdoc")
+        .def("plan_coarse",
+             [](Planner &self, const std::vector<float> &start, const std::vector<float> &goal, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 std::unique_ptr<Planner::CoarsePath> path;
+                 double time_spent = 0.0;
+                 int status;
+                 {
+                     py::gil_scoped_release release;
+                     status = self.planCoarse(start, goal, options, path, time_spent);
+                 }
+                 py::object coarse = path ? py::cast(std::move(path)) : py::none();
+                 return std::make_tuple(status, coarse, time_spent);
+             },
+             py::arg("start"),
+             py::arg("goal"),
+             R"pbdoc(
+            Finds only the coarse HPA* path from start to goal; the abstract graph is built on the first call
+            and kept. Its segments are refined when asked for, so the caller can start walking the first one
+            right away. Segments are refined with A*, or Theta* if searchtype is "theta", "lazytheta" or "hpatheta".
+
+            Returns:
+                tuple[int, CoarsePath | None, float]: status (0 if a path was found, -1 otherwise),
+                the coarse path and the planning time in milliseconds.
+          )pbdoc")
+        .def("save_path_database",
+             [](Planner &self, const std::string &file_name, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 py::gil_scoped_release release;
+                 return self.savePreprocessing<PathDatabase>(file_name, options);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Writes the compressed path database of the map for searchtype="cpd" to file_name, building it first
+            (one Dijkstra search per free cell, on all cores) unless a "cpd" query already has. Keyword arguments
+            select the movement rules (allowdiagonal, cutcorners, allowsqueeze). Returns False if the file cannot
+            be written.
+          )pbdoc")
+        .def("load_path_database",
+             [](Planner &self, const std::string &file_name) {
+                 py::gil_scoped_release release;
+                 return self.loadPreprocessing<PathDatabase>(file_name);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Reads a database written by save_path_database for the same map; later "cpd" queries with its movement
+            rules use it instead of building one. Returns False if the file cannot be read or belongs to another map.
+          )pbdoc")
+        .def("save_contraction_hierarchy",
+             [](Planner &self, const std::string &file_name, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 py::gil_scoped_release release;
+                 return self.savePreprocessing<ContractionHierarchy>(file_name, options);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Writes the contraction hierarchy of the map for searchtype="ch" to file_name, building it first
+            (the node ordering runs on all cores) unless a "ch" query already has. Keyword arguments select the
+            movement rules (allowdiagonal, cutcorners, allowsqueeze). Returns False if the file cannot be written.
+          )pbdoc")
+        .def("load_contraction_hierarchy",
+             [](Planner &self, const std::string &file_name) {
+                 py::gil_scoped_release release;
+                 return self.loadPreprocessing<ContractionHierarchy>(file_name);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Reads a hierarchy written by save_contraction_hierarchy for the same map; later "ch" queries with its
+            movement rules use it. Returns False if the file cannot be read or belongs to another map.
+          )pbdoc")
+        .def("save_hub_labels",
+             [](Planner &self, const std::string &file_name, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 py::gil_scoped_release release;
+                 return self.savePreprocessing<HubLabels>(file_name, options);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Writes the hub labels of the map for searchtype="hl" to file_name, building them first (from the
+            contraction hierarchy, which is built too if there is none) unless an "hl" query already has. Keyword
+            arguments select the movement rules. Returns False if the file cannot be written.
+          )pbdoc")
+        .def("load_hub_labels",
+             [](Planner &self, const std::string &file_name) {
+                 py::gil_scoped_release release;
+                 return self.loadPreprocessing<HubLabels>(file_name);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Maps labels written by save_hub_labels for the same map into memory; later "hl" queries with their
+            movement rules use them. Returns False if the file cannot be read or belongs to another map.
+          )pbdoc")
+        .def("save_goal_bounds",
+             [](Planner &self, const std::string &file_name, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 py::gil_scoped_release release;
+                 return self.savePreprocessing<GoalBounds>(file_name, options);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Writes the goal bounds of the map for goalbounding=True to file_name, building them first (one
+            Dijkstra search per free cell, on all cores) unless a query already has. Keyword arguments select the
+            movement rules. Returns False if the file cannot be written.
+          )pbdoc")
+        .def("load_goal_bounds",
+             [](Planner &self, const std::string &file_name) {
+                 py::gil_scoped_release release;
+                 return self.loadPreprocessing<GoalBounds>(file_name);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Reads goal bounds written by save_goal_bounds for the same map; later goalbounding queries with their
+            movement rules use them. Returns False if the file cannot be read or belongs to another map.
+          )pbdoc")
+        .def("save_subgoal_graph",
+             [](Planner &self, const std::string &file_name, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 py::gil_scoped_release release;
+                 return self.savePreprocessing<SubgoalGraph>(file_name, options);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Writes the subgoal graph of the map for searchtype="subgoal" to file_name, building it first (on all
+            cores) unless a "subgoal" query already has. Keyword arguments select the movement rules. Returns False
+            if the file cannot be written.
+          )pbdoc")
+        .def("load_subgoal_graph",
+             [](Planner &self, const std::string &file_name) {
+                 py::gil_scoped_release release;
+                 return self.loadPreprocessing<SubgoalGraph>(file_name);
+             },
+             py::arg("file_name"),
+             R"pbdoc(
+            Reads a graph written by save_subgoal_graph for the same map; later "subgoal" queries with its movement
+            rules use it. Returns False if the file cannot be read or belongs to another map.
+          )pbdoc")
+        .def("component",
+             [](Planner &self, const std::vector<float> &point, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 py::gil_scoped_release release;
+                 return self.component(point, options);
+             },
+             py::arg("point"),
+             R"pbdoc(
+            Connected component of the cell under point ([x, y] in meters), -1 if it is outside the map or blocked.
+            Two points are connected if and only if their components are equal, so unreachable goals can be
+            filtered out before planning. Keyword arguments select the movement rules (allowdiagonal, cutcorners,
+            allowsqueeze); the labels are computed once per map and rule set and shared with plan().
+          )pbdoc")
+        .def("components",
+             [](Planner &self, const py::object &points, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 std::vector<float> flat = toPoints(points);
+                 std::vector<int> ids;
+                 {
+                     py::gil_scoped_release release;
+                     self.components(flat, options, ids);
+                 }
+                 py::array_t<int> result(static_cast<py::ssize_t>(ids.size()));
+                 std::copy(ids.begin(), ids.end(), result.mutable_data());
+                 return result;
+             },
+             py::arg("points"),
+             "Components of an (N, 2) array of points as an int array, see component().")
+        .def("set_option",
+             [](Planner &self, const std::string &tag, const py::object &value) {
+                 py::kwargs kwargs;
+                 kwargs[py::str(tag)] = value;
+                 Planner::Options options = toOptions(kwargs);
+                 self.setOption(tag, options[tag]);
+             },
+             py::arg("tag"),
+             py::arg("value"),
+             "Sets the default value of an option for all later queries.")
+        .def_property_readonly("width", &Planner::getWidth)
+        .def_property_readonly("height", &Planner::getHeight);
+
+    py::class_<Planner::CoarsePath>(m, "CoarsePath", R"pbdoc(
+            Coarse HPA* path returned by Planner.plan_coarse. len() is the number of segments, segment k runs
+            from waypoints[k] to waypoints[k + 1]. Refining releases the GIL, but one path must not be refined
+            from two threads at once.
+          )pbdoc")
+        .def("__len__", &Planner::CoarsePath::segments)
+        .def_property_readonly("waypoints",
+             [](const Planner::CoarsePath &self) {
+                 std::vector<double> points;
+                 self.waypoints(points);
+                 return pathArray(std::move(points));
+             },
+             "(N, 2) float64 array of the coarse waypoints, from start to goal.")
+        .def("segment",
+             [](Planner::CoarsePath &self, int k) {
+                 if (k < 0 || k >= self.segments())
+                     throw py::index_error("segment index out of range");
+                 std::vector<double> points;
+                 {
+                     py::gil_scoped_release release;
+                     self.refine(k, points);
+                 }
+                 return pathArray(std::move(points));
+             },
+             py::arg("k"),
+             "Refines segment k and returns its (N, 2) path, both waypoints included (empty if it cannot be refined).")
+        .def("path",
+             [](Planner::CoarsePath &self) {
+                 std::vector<double> points, segment;
+                 {
+                     py::gil_scoped_release release;
+                     for (int k = 0; k < self.segments(); k++) {
+                         if (!self.refine(k, segment)) {
+                             points.clear();
+                             break;
+                         }
+                         //Every segment starts where the previous one ended
+                         points.insert(points.end(), segment.begin() + (points.empty() ? 0 : 2), segment.end());
+                     }
+                 }
+                 return pathArray(std::move(points));
+             },
+             "Refines all segments and returns the whole (N, 2) path, empty if a segment cannot be refined.");
+
+    py::class_<Replanner>(m, "Replanner", R"pbdoc(
+            Plans to one goal again and again while the start moves and cells change, with D* Lite. The search
+            is kept between calls, so plan() after moving the start or changing a few cells only repairs the
+            part of the search the changes touch. The replanner has its own copy of the map; report changes
+            with set_cells() or update_map(). plan() releases the GIL, but a Replanner must not be used from
+            two threads at once.
+          )pbdoc")
+        .def(py::init([](const std::vector<float> &origin, const std::vector<int> &dim, const py::object &map_data, double resolution,
+                         const std::vector<float> &start, const std::vector<float> &goal, const py::kwargs &kwargs) {
+                 Planner::Options options = toOptions(kwargs);
+                 py::array cells = cellArray(map_data);
+                 std::unique_ptr<Replanner> replanner;
+                 {
+                     py::gil_scoped_release release;
+                     replanner.reset(new Replanner(origin, dim, static_cast<const signed char *>(cells.data()),
+                                                   static_cast<std::size_t>(cells.size()), resolution, start, goal, options));
+                 }
+                 if (!replanner->isLoaded())
+                     throw py::value_error("map_data does not match dim, origin, dim or resolution is malformed, "
+                                           "or start or goal is outside the map");
+                 return replanner;
+             }),
+             py::arg("origin"),
+             py::arg("dim"),
+             py::arg("map_data"),
+             py::arg("resolution"),
+             py::arg("start"),
+             py::arg("goal"),
+             R"pbdoc(
+            Args are the same as for plan_2d. Keyword arguments select the movement rules (allowdiagonal,
+            cutcorners, allowsqueeze); paths are shortest on the 8-connected (4-connected without diagonal
+            moves) grid whatever the metric.
+          )pbdoc")
+        .def("plan",
+             [](Replanner &self) {
+                 std::vector<double> path;
+                 double time_spent = 0.0;
+                 int status;
+                 {
+                     py::gil_scoped_release release;
+                     status = self.plan(path, time_spent);
+                 }
+                 return std::make_tuple(status, pathArray(std::move(path)), time_spent);
+             },
+             R"pbdoc(
+            Plans from the current start to the goal.
+
+            Returns:
+                tuple[int, numpy.ndarray, float]: as Planner.plan.
+          )pbdoc")
+        .def("move_start",
+             [](Replanner &self, const std::vector<float> &start) {
+                 if (!self.setStart(start))
+                     throw py::value_error("start is outside the map");
+             },
+             py::arg("start"),
+             "Moves the start to [x, y] (in meters), e.g. to the position the robot has reached.")
+        .def("set_goal",
+             [](Replanner &self, const std::vector<float> &goal) {
+                 if (!self.setGoal(goal))
+                     throw py::value_error("goal is outside the map");
+             },
+             py::arg("goal"),
+             "Sets a new goal. The search starts over, the changes reported so far are kept.")
+        .def("set_cells",
+             [](Replanner &self, const py::object &points, bool blocked) {
+                 std::vector<float> flat = toPoints(points);
+                 return self.setCells(flat, blocked);
+             },
+             py::arg("points"),
+             py::arg("blocked") = true,
+             "Marks the cells under an (N, 2) array of points as blocked (or free), returns how many were on the map.")
+        .def("update_map",
+             [](Replanner &self, const py::object &map_data) {
+                 py::array cells = cellArray(map_data);
+                 bool updated;
+                 {
+                     py::gil_scoped_release release;
+                     updated = self.updateMap(static_cast<const signed char *>(cells.data()), static_cast<std::size_t>(cells.size()));
+                 }
+                 if (!updated)
+                     throw py::value_error("map_data does not match the size of the map");
+             },
+             py::arg("map_data"),
+             "Takes a whole new map of the same size; only the cells that differ from the current one are repaired.")
+        .def_property_readonly("expansions", &Replanner::getExpansions, "Cells expanded by the last plan().")
+        .def_property_readonly("width", &Replanner::getWidth)
+        .def_property_readonly("height", &Replanner::getHeight);
+
 #ifdef VERSION_INFO
     m.attr("__version__") = VERSION_INFO;
 #else
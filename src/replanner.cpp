@@ -0,0 +1,111 @@
+#include "replanner.h"
+#include <chrono>
+#include <cmath>
+
+Replanner::Replanner(const std::vector<float> &origin, const std::vector<int> &dim, const signed char *map, std::size_t map_size,
+                     double resolution, const std::vector<float> &start, const std::vector<float> &goal,
+                     const Planner::Options &options)
+{
+    loaded = false;
+    expansions = 0;
+    height = width = 0;
+    origin_x = origin.size() > 0 ? origin[0] : 0;
+    origin_y = origin.size() > 1 ? origin[1] : 0;
+    this->resolution = resolution;
+    if (origin.size() < 2 || dim.size() < 2 || resolution <= 0)
+        return;
+    if (dim[0] <= 0 || dim[1] <= 0 || map_size < static_cast<std::size_t>(dim[0]) * dim[1])
+        return;
+    Config config;
+    config.setDefaultConfigAstar();
+    for (Planner::Options::const_iterator it = options.begin(); it != options.end(); ++it)
+        if (!config.setParamByTag(it->first, it->second))
+            return; // Unknown option
+    Map grid;
+    if (!grid.loadGrid(map, dim[1], dim[0], resolution))
+        return;
+    width = grid.width;
+    height = grid.height;
+    int start_x, start_y, goal_x, goal_y;
+    if (!toCell(start, start_x, start_y) || !toCell(goal, goal_x, goal_y))
+        return;
+    //Blocked endpoints are accepted, there is no path until they are freed
+    grid.setEndpoints(start_x, start_y, goal_x, goal_y);
+    search.reset(grid, EnvironmentOptions(config.SearchParams[CN_SP_AS], config.SearchParams[CN_SP_AD],
+                                          config.SearchParams[CN_SP_CC], config.SearchParams[CN_SP_MT]));
+    loaded = true;
+}
+
+bool Replanner::toCell(const std::vector<float> &point, int &x, int &y) const
+{
+    if (point.size() < 2)
+        return false;
+    double cx = std::floor((point[0] - origin_x) / resolution);
+    double cy = std::floor((point[1] - origin_y) / resolution);
+    if (cx < 0 || cx >= width || cy < 0 || cy >= height)
+        return false;
+    x = static_cast<int>(cx);
+    y = static_cast<int>(cy);
+    return true;
+}
+
+bool Replanner::setStart(const std::vector<float> &start)
+{
+    int x, y;
+    return loaded && toCell(start, x, y) && search.setStart(y, x);
+}
+
+bool Replanner::setGoal(const std::vector<float> &goal)
+{
+    int x, y;
+    return loaded && toCell(goal, x, y) && search.setGoal(y, x);
+}
+
+int Replanner::setCells(const std::vector<float> &points, bool blocked)
+{
+    if (!loaded)
+        return 0;
+    int count = 0;
+    std::vector<float> point(2);
+    for (std::size_t k = 0; k + 1 < points.size(); k += 2) {
+        int x, y;
+        point[0] = points[k];
+        point[1] = points[k + 1];
+        if (toCell(point, x, y)) {
+            search.setCell(y, x, blocked);
+            count++;
+        }
+    }
+    return count;
+}
+
+bool Replanner::updateMap(const signed char *map, std::size_t map_size)
+{
+    if (!loaded || map_size < static_cast<std::size_t>(height) * width)
+        return false;
+    Map grid;
+    if (!grid.loadGrid(map, height, width, resolution))
+        return false;
+    search.updateGrid(grid.getGrid());
+    return true;
+}
+
+int Replanner::plan(std::vector<double> &path, double &time_spent)
+{
+    path.clear();
+    time_spent = 0;
+    if (!loaded)
+        return -1;
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    SearchResult result = search.replan();
+    time_spent = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    expansions = result.numberofsteps;
+    if (!result.pathfound)
+        return -1;
+    path.reserve(result.lppath->size() * 2);
+    for (std::list<Node>::const_iterator it = result.lppath->begin(); it != result.lppath->end(); ++it) {
+        path.push_back(origin_x + it->j * resolution);
+        path.push_back(origin_y + it->i * resolution);
+    }
+    return 0;
+}
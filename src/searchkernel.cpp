@@ -0,0 +1,202 @@
+#include "searchkernel.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+template <class Metric, int Movement, bool GMax, bool AnyAngle, bool Lazy>
+SearchResult SearchKernel<Metric, Movement, GMax, AnyAngle, Lazy>::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    //The kernel is only valid for the options it was instantiated for
+    if (options.movementRules() != Movement || options.metrictype != Metric::type)
+        return Base::startSearch(map, options);
+
+    //Same neighbour order as ISearch::findSuccessors, so both produce the same paths
+    static const int moves[8][2] = {{1, 1}, {1, 0}, {1, -1}, {0, 1}, {0, -1}, {-1, 1}, {-1, 0}, {-1, -1}};
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    SearchResult &sresult = this->sresult;
+    CellStateTable &cells = this->cells;
+    const double hweight = this->hweight;
+    sresult = SearchResult();
+    this->lppath.clear();
+    this->hppath.clear();
+    cells.reset(map.height, map.width);
+    heap.reset(map.height, map.width);
+
+    Node curNode;
+    curNode.i = map.start_i;
+    curNode.j = map.start_j;
+    curNode.g = 0;
+    curNode.H = Metric::distance(map.goal_i - curNode.i, map.goal_j - curNode.j);
+    curNode.F = hweight * curNode.H;
+    curNode.parent = -1;
+    heap.push(curNode);
+    cells.setOpen(cells.index(curNode.i, curNode.j), curNode.g, curNode.parent);
+    int closeSize = 0;
+    unsigned int sightChecks = 0;
+    bool pathfound = false, stopped = false;
+    Node closest = curNode;
+    while (!heap.empty()) {
+        if (this->limitReached(closeSize, start)) {
+            stopped = true;
+            break;
+        }
+        curNode = heap.top();
+        heap.pop();
+        int curId = cells.index(curNode.i, curNode.j);
+        if (Lazy && curNode.parent >= 0) {
+            Node parent = cells.node(curNode.parent);
+            //Links to a neighbour are moves the cell was generated by, so they need no line
+            bool adjacent = std::abs(parent.i - curNode.i) <= 1 && std::abs(parent.j - curNode.j) <= 1;
+            if (!adjacent)
+                sightChecks++;
+            if (!adjacent && !Theta::lineOfSight<Movement == CN_MR_CORNER || Movement == CN_MR_SQUEEZE>(parent.i, parent.j,
+                                                                                          curNode.i, curNode.j, map)) {
+                //The cell it was generated from is one of the closed neighbours, so there always is one
+                curNode.g = std::numeric_limits<double>::infinity();
+                for (int k = 0; k < 8; k++) {
+                    int di = moves[k][0], dj = moves[k][1];
+                    bool diagonal = (di != 0 && dj != 0);
+                    if ((Movement == CN_MR_CARDINAL && diagonal) || !map.CellIsTraversable(curNode.i + di, curNode.j + dj) ||
+                            (diagonal && !diagonalMoveAllowed<Movement>(map, curNode.i, curNode.j, di, dj)))
+                        continue;
+                    int id = cells.index(curNode.i + di, curNode.j + dj);
+                    double g = cells[id].g + (diagonal ? sqrt(2) : 1);
+                    if (cells.isClosed(id) && g < curNode.g) {
+                        curNode.g = g;
+                        curNode.parent = id;
+                    }
+                }
+                cells.setOpen(curId, curNode.g, curNode.parent);
+                //The repaired cell goes back to OPEN if it is no longer the best one, so a cheaper parent closed
+                //later still reaches it. Otherwise its optimistic F would let it pass cells with a smaller true F
+                curNode.F = curNode.g + hweight * curNode.H;
+                if (!heap.empty() && heap.top().F < curNode.F) {
+                    heap.push(curNode);
+                    continue;
+                }
+            }
+        }
+        cells.setClosed(curId);
+        closeSize++;
+        if (curNode.i == map.goal_i && curNode.j == map.goal_j) {
+            pathfound = true;
+            break;
+        }
+        if (curNode.H < closest.H)
+            closest = curNode;
+        Node grandparent;
+        if (AnyAngle && curNode.parent >= 0)
+            grandparent = cells.node(curNode.parent);
+        for (int k = 0; k < 8; k++) {
+            int di = moves[k][0], dj = moves[k][1];
+            bool diagonal = (di != 0 && dj != 0);
+            if (Movement == CN_MR_CARDINAL && diagonal)
+                continue;
+            Node newNode;
+            newNode.i = curNode.i + di;
+            newNode.j = curNode.j + dj;
+            if (!map.CellIsTraversable(newNode.i, newNode.j) ||
+                    (diagonal && !diagonalMoveAllowed<Movement>(map, curNode.i, curNode.j, di, dj)))
+                continue;
+            int id = cells.index(newNode.i, newNode.j);
+            if (cells.isClosed(id))
+                continue;
+            newNode.g = curNode.g + (diagonal ? sqrt(2) : 1);
+            newNode.parent = curId;
+            if (AnyAngle && curNode.parent >= 0 && !(newNode == grandparent)) {
+                bool visible = Lazy;//checked once the successor is expanded
+                if (!Lazy) {
+                    sightChecks++;
+                    visible = Theta::lineOfSight<Movement == CN_MR_CORNER || Movement == CN_MR_SQUEEZE>(grandparent.i, grandparent.j,
+                                                                                                         newNode.i, newNode.j, map);
+                }
+                if (visible) {
+                    newNode.g = grandparent.g + Theta::distance(grandparent.i, grandparent.j, newNode.i, newNode.j);
+                    newNode.parent = curNode.parent;
+                }
+            }
+            newNode.H = Metric::distance(map.goal_i - newNode.i, map.goal_j - newNode.j);
+            newNode.F = newNode.g + hweight * newNode.H;
+            if (heap.push(newNode))
+                cells.setOpen(id, newNode.g, newNode.parent);
+        }
+    }
+    sresult.nodescreated = closeSize + heap.size();
+    sresult.numberofsteps = closeSize;
+    sresult.lineofsightchecks = sightChecks;
+    if (pathfound) {
+        sresult.pathfound = true;
+        if (!this->distanceonly)
+            Base::makePrimaryPath(curNode);
+        sresult.pathlength = curNode.g;
+    }
+    else if (stopped) {
+        sresult.partial = true;
+        if (!this->distanceonly)
+            Base::makePrimaryPath(closest);
+        sresult.pathlength = closest.g;
+    }
+    //Stop the timer now because making path using back pointers is a part of the algorithm
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
+    if ((pathfound || stopped) && !this->distanceonly)
+        Base::makeSecondaryPath();
+
+    sresult.hppath = &this->hppath;
+    sresult.lppath = &this->lppath;
+    return sresult;
+}
+
+template <class Metric, int Movement, bool GMax>
+static ISearch* createKernel(int searchtype, double hweight)
+{
+    if (searchtype == CN_SP_ST_LTH)
+        return new SearchKernel<Metric, Movement, GMax, true, true>(hweight);
+    if (searchtype == CN_SP_ST_TH)
+        return new SearchKernel<Metric, Movement, GMax, true>(hweight);
+    return new SearchKernel<Metric, Movement, GMax, false>(hweight);
+}
+
+template <class Metric, int Movement>
+static ISearch* createKernel(int searchtype, bool breakingties, double hweight)
+{
+    if (breakingties == CN_SP_BT_GMAX)
+        return createKernel<Metric, Movement, true>(searchtype, hweight);
+    return createKernel<Metric, Movement, false>(searchtype, hweight);
+}
+
+template <class Metric>
+static ISearch* createKernel(int movement, int searchtype, bool breakingties, double hweight)
+{
+    switch (movement) {
+        case CN_MR_CARDINAL:
+            return createKernel<Metric, CN_MR_CARDINAL>(searchtype, breakingties, hweight);
+        case CN_MR_NOCORNER:
+            return createKernel<Metric, CN_MR_NOCORNER>(searchtype, breakingties, hweight);
+        case CN_MR_CORNER:
+            return createKernel<Metric, CN_MR_CORNER>(searchtype, breakingties, hweight);
+        case CN_MR_SQUEEZE:
+            return createKernel<Metric, CN_MR_SQUEEZE>(searchtype, breakingties, hweight);
+        default:
+            return nullptr;
+    }
+}
+
+ISearch* createSearchKernel(int searchtype, int metrictype, int movement, bool breakingties, double hweight)
+{
+    if (searchtype != CN_SP_ST_ASTAR && searchtype != CN_SP_ST_TH && searchtype != CN_SP_ST_LTH)
+        return nullptr;
+    switch (metrictype) {
+        case CN_SP_MT_EUCL:
+            return createKernel<EuclidMetric>(movement, searchtype, breakingties, hweight);
+        case CN_SP_MT_DIAG:
+            return createKernel<DiagonalMetric>(movement, searchtype, breakingties, hweight);
+        case CN_SP_MT_MANH:
+            return createKernel<ManhattanMetric>(movement, searchtype, breakingties, hweight);
+        case CN_SP_MT_CHEB:
+            return createKernel<ChebyshevMetric>(movement, searchtype, breakingties, hweight);
+        default:
+            return nullptr;
+    }
+}
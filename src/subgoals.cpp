@@ -0,0 +1,569 @@
+#include "subgoals.h"
+#include "searchkernel.h"
+#include "threadpool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+
+#define CN_SG_EPS 1e-7 //path lengths closer than this are equal (distinct sums of 1 and sqrt(2) differ by far more)
+
+static const char sgMagic[4] = {'S', 'U', 'B', 'G'};
+
+SubgoalGraph::SubgoalGraph()
+{
+    height = 0;
+    width = 0;
+    movement = CN_MR_NOCORNER;
+    buildTime = 0;
+}
+
+bool SubgoalGraph::fits(const Map &map, const EnvironmentOptions &options) const
+{
+    return movement == options.movementRules() && grid &&
+           (grid == map.getSharedGrid() || *grid == map.getGrid());
+}
+
+std::size_t SubgoalGraph::memoryUsage() const
+{
+    return (node.size() + 3 * cells.size() + links.size()) * sizeof(int32_t) + first.size() * sizeof(uint32_t) + local.size() +
+           4 * node.size() * sizeof(uint16_t);
+}
+
+double SubgoalGraph::metric(int di, int dj) const
+{
+    di = std::abs(di);
+    dj = std::abs(dj);
+    if (movement == CN_MR_CARDINAL)
+        return di + dj;
+    return sqrt(2) * std::min(di, dj) + std::abs(di - dj);
+}
+
+bool SubgoalGraph::moveAllowed(const Map &map, int i, int j, int di, int dj) const
+{
+    if (!map.CellIsTraversable(i + di, j + dj))
+        return false;
+    if (di == 0 || dj == 0)
+        return true;
+    switch (movement) {
+        case CN_MR_NOCORNER:
+            return diagonalMoveAllowed<CN_MR_NOCORNER>(map, i, j, di, dj);
+        case CN_MR_CORNER:
+            return diagonalMoveAllowed<CN_MR_CORNER>(map, i, j, di, dj);
+        case CN_MR_SQUEEZE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//Without corner cutting shortest paths bend on the cell diagonal to the corner of an obstacle. When diagonal moves
+//may touch obstacles they pass the corner between its two free neighbours and bend on these instead
+void SubgoalGraph::placeSubgoals()
+{
+    node.assign(static_cast<std::size_t>(height) * width, -1);
+    cells.clear();
+    rows.clear();
+    columns.clear();
+    for (int i = 0; i < height; i++)
+        for (int j = 0; j < width; j++) {
+            if (grid->isObstacle(i, j))
+                continue;
+            bool subgoal = false;
+            for (int di = -1; di <= 1 && !subgoal; di += 2)
+                for (int dj = -1; dj <= 1 && !subgoal; dj += 2) {
+                    if (movement == CN_MR_CARDINAL || movement == CN_MR_NOCORNER)
+                        subgoal = grid->isObstacle(i + di, j + dj) && !grid->isObstacle(i + di, j) && !grid->isObstacle(i, j + dj);
+                    else
+                        subgoal = !grid->isObstacle(i + di, j + dj) && (grid->isObstacle(i + di, j) || grid->isObstacle(i, j + dj));
+                }
+            if (subgoal) {
+                node[static_cast<std::size_t>(i) * width + j] = static_cast<int32_t>(cells.size());
+                cells.push_back(i * width + j);
+                rows.push_back(i);
+                columns.push_back(j);
+            }
+        }
+    //Steps from every cell to the next obstacle or subgoal down, up, right and left; 0xFFFF or more counts 0xFFFF
+    static const int straight[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+    for (int d = 0; d < 4; d++) {
+        int di = straight[d][0], dj = straight[d][1];
+        clearance[d].assign(static_cast<std::size_t>(height) * width, 0);
+        for (int n = 0; n < height; n++)
+            for (int m = 0; m < width; m++) {
+                int i = (di > 0 ? height - 1 - n : n), j = (dj > 0 ? width - 1 - m : m);
+                int next = 1;
+                if (!grid->isObstacle(i + di, j + dj) && node[static_cast<std::size_t>(i + di) * width + j + dj] < 0)
+                    next = std::min(clearance[d][static_cast<std::size_t>(i + di) * width + j + dj] + 1, 0xFFFF);
+                clearance[d][static_cast<std::size_t>(i) * width + j] = static_cast<uint16_t>(next);
+            }
+    }
+}
+
+//The h-paths of a direction pair take x moves (di, dj) and y moves (ci, cj) in any order. The pairs are a diagonal
+//with one of its straight parts (eight in all), or two straight moves at a right angle when there are no diagonals.
+//The reachable (x, y) are swept a row of equal x at a time. A row is a list of runs: every cell the move (di, dj)
+//reaches from a run of the row before starts one, which goes on with moves (ci, cj) up to the next obstacle or
+//subgoal, so open space takes a step per row
+bool SubgoalGraph::reach(const Map &map, int i, int j, int target, std::vector<int> &found, Sweep &sweep) const
+{
+    std::size_t begin = found.size();
+    bool targetFound = (target == i * width + j);
+    int pairs = (movement == CN_MR_CARDINAL ? 4 : 8);
+    for (int k = 0; k < pairs; k++) {
+        int di = (k & 1) ? -1 : 1, dj = (k & 2) ? -1 : 1, ci, cj;
+        if (movement == CN_MR_CARDINAL) {
+            ci = 0;
+            cj = dj;
+            dj = 0;
+        }
+        else {
+            ci = (k & 4) ? 0 : di;
+            cj = (k & 4) ? dj : 0;
+        }
+        //Target in the (x, y) of the pair (the moves are independent, so the determinant is 1 or -1)
+        int ti = target / width - i, tj = target % width - j, det = di * cj - dj * ci;
+        int tx = (target < 0 ? -1 : (ti * cj - tj * ci) * det), ty = (di * tj - dj * ti) * det;
+        const std::vector<uint16_t> &clear = clearance[ci != 0 ? (ci > 0 ? 0 : 1) : (cj > 0 ? 2 : 3)];
+        std::vector<int> *prev = &sweep.runs[0], *cur = &sweep.runs[1];
+        //Adds the run from the free cell (x, y) and returns the y of the obstacle or subgoal that ends it
+        auto extend = [&](int x, int y) {
+            int i1 = i + x * di + y * ci, j1 = j + x * dj + y * cj, length = 0, step;
+            do {
+                step = clear[static_cast<std::size_t>(i1 + length * ci) * width + j1 + length * cj];
+                length += step;
+            } while (step == 0xFFFF);
+            cur->push_back(y);
+            cur->push_back(y + length - 1);
+            targetFound = targetFound || (x == tx && ty >= y && ty < y + length);
+            i1 += length * ci;
+            j1 += length * cj;
+            if (!grid->isObstacle(i1, j1)) {
+                found.push_back(node[static_cast<std::size_t>(i1) * width + j1]);
+                targetFound = targetFound || (x == tx && ty == y + length);
+            }
+            return y + length;
+        };
+        cur->clear();
+        extend(0, 0);
+        for (int x = 1; !cur->empty(); x++) {
+            std::swap(prev, cur);
+            cur->clear();
+            int done = -1;
+            for (std::size_t r = 0; r < prev->size(); r += 2)
+                for (int y = std::max((*prev)[r], done + 1); y <= (*prev)[r + 1]; y++) {
+                    int i1 = i + x * di + y * ci, j1 = j + x * dj + y * cj;
+                    if (!moveAllowed(map, i1 - di, j1 - dj, di, dj))
+                        continue;
+                    int v = node[static_cast<std::size_t>(i1) * width + j1];
+                    if (v >= 0) {
+                        found.push_back(v);
+                        targetFound = targetFound || (x == tx && y == ty);
+                        done = y;
+                    }
+                    else
+                        done = y = extend(x, y);
+                }
+        }
+    }
+    //Subgoals on a diagonal or a straight line from (i, j) are found by two pairs
+    std::sort(found.begin() + begin, found.end());
+    found.erase(std::unique(found.begin() + begin, found.end()), found.end());
+    return targetFound;
+}
+
+bool SubgoalGraph::refine(const Map &map, int i1, int j1, int i2, int j2, std::vector<int> &path, Sweep &sweep) const
+{
+    int a = std::abs(i2 - i1), b = std::abs(j2 - j1), di = (i2 < i1 ? -1 : 1), dj = (j2 < j1 ? -1 : 1), ci, cj, X, Y;
+    if (movement == CN_MR_CARDINAL) {
+        ci = 0;
+        cj = dj;
+        dj = 0;
+        X = a;
+        Y = b;
+    }
+    else {
+        ci = (a >= b ? di : 0);
+        cj = (a >= b ? 0 : dj);
+        X = std::min(a, b);
+        Y = std::abs(a - b);
+    }
+    //Every entry records the move that reached it: 1 for (di, dj), 2 for (ci, cj), 3 for the start
+    std::vector<uint8_t> &table = sweep.table;
+    table.assign(static_cast<std::size_t>(X + 1) * (Y + 1), 0);
+    for (int x = 0; x <= X; x++)
+        for (int y = 0; y <= Y; y++) {
+            int i = i1 + x * di + y * ci, j = j1 + x * dj + y * cj;
+            uint8_t &entry = table[static_cast<std::size_t>(x) * (Y + 1) + y];
+            if (x == 0 && y == 0)
+                entry = 3;
+            else if (x > 0 && table[static_cast<std::size_t>(x - 1) * (Y + 1) + y] && moveAllowed(map, i - di, j - dj, di, dj))
+                entry = 1;
+            else if (y > 0 && table[static_cast<std::size_t>(x) * (Y + 1) + y - 1] && moveAllowed(map, i - ci, j - cj, ci, cj))
+                entry = 2;
+        }
+    if (!table.back())
+        return false;
+    std::size_t end = path.size();
+    for (int x = X, y = Y; x > 0 || y > 0; ) {
+        path.push_back((i1 + x * di + y * ci) * width + j1 + x * dj + y * cj);
+        if (table[static_cast<std::size_t>(x) * (Y + 1) + y] == 1)
+            x--;
+        else
+            y--;
+    }
+    std::reverse(path.begin() + end, path.end());
+    return true;
+}
+
+//Second level: one by one, a subgoal becomes local when the shortest paths between its remaining neighbours do not
+//need it, either because the graph without it is as short or because they are h-reachable, in which case the two
+//are linked. A local subgoal keeps its links to the subgoals that remain, so like in a contraction hierarchy a
+//shortest path climbs from its ends to the global subgoals over these links
+static void splitLevels(const SubgoalGraph &graph, std::vector<std::vector<int>> &adjacent, std::vector<uint8_t> &local)
+{
+    typedef std::pair<double, int> Entry;
+    const double infinity = std::numeric_limits<double>::infinity();
+    int n = graph.nodes();
+    auto cost = [&](int v, int w) {return graph.metric(graph.rows[v] - graph.rows[w], graph.columns[v] - graph.columns[w]);};
+    std::vector<double> dist(n, infinity);
+    std::vector<int> touched;
+    std::vector<Entry> queue;
+    std::vector<std::pair<int, int>> added;
+    local.assign(n, 0);
+    for (int v = 0; v < n; v++) {
+        const std::vector<int> &around = adjacent[v];
+        bool keep = false;
+        added.clear();
+        for (std::size_t a = 0; a < around.size() && !keep; a++) {
+            int p = around[a];
+            double limit = 0;
+            for (std::size_t b = a + 1; b < around.size(); b++)
+                limit = std::max(limit, cost(p, v) + cost(v, around[b]));
+            //Dijkstra search from p around v, as far as the longest path through v to a later neighbour. A search
+            //that gives up only keeps v global or adds a link
+            dist[p] = 0;
+            touched.assign(1, p);
+            queue.assign(1, Entry(0, p));
+            for (int settled = 0; !queue.empty() && settled < CN_SG_SETTLED; ) {
+                std::pop_heap(queue.begin(), queue.end(), std::greater<Entry>());
+                Entry entry = queue.back();
+                queue.pop_back();
+                if (entry.first > dist[entry.second])
+                    continue;
+                settled++;
+                const std::vector<int> &next = adjacent[entry.second];
+                for (std::size_t k = 0; k < next.size(); k++) {
+                    int w = next[k];
+                    double g = entry.first + cost(entry.second, w);
+                    if (w == v || g > limit + CN_SG_EPS || g >= dist[w])
+                        continue;
+                    if (dist[w] == infinity)
+                        touched.push_back(w);
+                    dist[w] = g;
+                    queue.push_back(Entry(g, w));
+                    std::push_heap(queue.begin(), queue.end(), std::greater<Entry>());
+                }
+            }
+            for (std::size_t b = a + 1; b < around.size() && !keep; b++) {
+                int q = around[b];
+                double length = cost(p, v) + cost(v, q);
+                if (dist[q] <= length + CN_SG_EPS)
+                    continue;
+                if (cost(p, q) >= length - CN_SG_EPS)
+                    added.push_back(std::make_pair(p, q));
+                else
+                    keep = true;
+            }
+            for (std::size_t k = 0; k < touched.size(); k++)
+                dist[touched[k]] = infinity;
+        }
+        if (keep)
+            continue;
+        local[v] = 1;
+        for (std::size_t a = 0; a < around.size(); a++) {
+            std::vector<int> &links = adjacent[around[a]];
+            links.erase(std::find(links.begin(), links.end(), v));
+        }
+        for (std::size_t k = 0; k < added.size(); k++) {
+            adjacent[added[k].first].push_back(added[k].second);
+            adjacent[added[k].second].push_back(added[k].first);
+        }
+    }
+}
+
+std::shared_ptr<const SubgoalGraph> SubgoalGraph::build(const Map &map, const EnvironmentOptions &options, int threads)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::shared_ptr<SubgoalGraph> result = std::make_shared<SubgoalGraph>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = options.movementRules();
+    result->grid = map.getSharedGrid();
+    result->placeSubgoals();
+
+    int n = result->nodes();
+    std::vector<std::vector<int>> found(n);
+    ThreadPool pool(threads);
+    std::vector<Sweep> sweeps(pool.size());
+    pool.run(n, [&](int worker, int v) {
+        result->reach(map, result->rows[v], result->columns[v], -1, found[v], sweeps[worker]);
+    });
+    //A link is dropped when another subgoal joins its ends through two links of the same total cost. Every dropped
+    //link is then replaced by cheaper ones, so shortest paths keep their length
+    const SubgoalGraph &graph = *result;
+    auto cost = [&](int v, int w) {return graph.metric(graph.rows[v] - graph.rows[w], graph.columns[v] - graph.columns[w]);};
+    std::vector<std::vector<int>> kept(n);
+    pool.run(n, [&](int, int v) {
+        for (std::size_t a = 0; a < found[v].size(); a++) {
+            int w = found[v][a];
+            bool redundant = false;
+            for (std::size_t b = 0; b < found[v].size() && !redundant; b++) {
+                int u = found[v][b];
+                redundant = (u != w && cost(v, u) + cost(u, w) <= cost(v, w) + CN_SG_EPS &&
+                             std::binary_search(found[u].begin(), found[u].end(), w));
+            }
+            if (!redundant)
+                kept[v].push_back(w);
+        }
+    });
+    splitLevels(graph, kept, result->local);
+    result->first.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        std::sort(kept[v].begin(), kept[v].end());
+        result->links.insert(result->links.end(), kept[v].begin(), kept[v].end());
+        result->first[v + 1] = static_cast<uint32_t>(result->links.size());
+    }
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+bool SubgoalGraph::save(const std::string &fileName) const
+{
+    std::ofstream file(fileName.c_str(), std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+    int32_t header[4] = {CN_SG_VERSION, height, width, movement};
+    uint64_t sizes[3] = {grid->fingerprint(), cells.size(), links.size()};
+    file.write(sgMagic, sizeof(sgMagic));
+    file.write(reinterpret_cast<const char *>(header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+    //The subgoals follow from the grid, so only the links and the levels are written
+    file.write(reinterpret_cast<const char *>(first.data()), first.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char *>(links.data()), links.size() * sizeof(int32_t));
+    file.write(reinterpret_cast<const char *>(local.data()), local.size());
+    file.close();
+    return !file.fail();
+}
+
+std::shared_ptr<const SubgoalGraph> SubgoalGraph::load(const std::string &fileName, const Map &map)
+{
+    std::chrono::time_point<std::chrono::steady_clock> begin = std::chrono::steady_clock::now();
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    char magic[4];
+    int32_t header[4];
+    uint64_t sizes[3];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char *>(header), sizeof(header));
+    file.read(reinterpret_cast<char *>(sizes), sizeof(sizes));
+    if (!file || memcmp(magic, sgMagic, sizeof(magic)) != 0 || header[0] != CN_SG_VERSION ||
+            header[1] != map.height || header[2] != map.width || header[3] < 0 || header[3] >= CN_MR_COUNT ||
+            sizes[0] != map.getGrid().fingerprint())
+        return nullptr;
+
+    std::shared_ptr<SubgoalGraph> result = std::make_shared<SubgoalGraph>();
+    result->height = map.height;
+    result->width = map.width;
+    result->movement = header[3];
+    result->grid = map.getSharedGrid();
+    result->placeSubgoals();
+    if (sizes[1] != result->cells.size() || sizes[2] >= (uint64_t(1) << 32))
+        return nullptr;
+    result->first.resize(result->cells.size() + 1);
+    result->links.resize(sizes[2]);
+    file.read(reinterpret_cast<char *>(result->first.data()), result->first.size() * sizeof(uint32_t));
+    file.read(reinterpret_cast<char *>(result->links.data()), result->links.size() * sizeof(int32_t));
+    result->local.resize(result->cells.size());
+    file.read(reinterpret_cast<char *>(result->local.data()), result->local.size());
+    if (!file || result->first[0] != 0 || result->first.back() != result->links.size())
+        return nullptr;
+    int n = result->nodes();
+    for (int v = 0; v < n; v++) {
+        if (result->first[v] > result->first[v + 1])
+            return nullptr;
+        for (uint32_t l = result->first[v]; l < result->first[v + 1]; l++)
+            if (result->links[l] < 0 || result->links[l] >= n || result->links[l] == v ||
+                    (!result->local[v] && result->local[result->links[l]]))
+                return nullptr;
+    }
+    result->buildTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return result;
+}
+
+SubgoalSearch::SubgoalSearch(std::shared_ptr<const SubgoalGraph> graph):Astar(1, CN_SP_BT_GMAX)
+{
+    this->graph = graph;
+}
+
+SearchResult SubgoalSearch::startSearch(const Map &map, const EnvironmentOptions &options)
+{
+    std::chrono::time_point<std::chrono::system_clock> start, end;
+    start = std::chrono::system_clock::now();
+    sresult = SearchResult();
+    lppath.clear();
+    hppath.clear();
+    if (!graph || !graph->fits(map, options)) {
+        graph = SubgoalGraph::build(map, options);
+        sresult.preprocessingtime = graph->buildTime;
+    }
+    sresult.preprocessingmemory = graph->memoryUsage();
+
+    //The start and the goal are the nodes after the subgoals
+    const double infinity = std::numeric_limits<double>::infinity();
+    int n = graph->nodes(), startNode = n, goalNode = n + 1;
+    if (dist.size() != static_cast<std::size_t>(n + 2)) {
+        dist.assign(n + 2, infinity);
+        parent.resize(n + 2);
+        toGoal.assign(n + 2, 0);
+        closed.assign(n + 2, 0);
+    }
+    int startCell = map.start_i * map.width + map.start_j, goalCell = map.goal_i * map.width + map.goal_j;
+    auto row = [&](int v) {return v < n ? graph->rows[v] : (v == startNode ? map.start_i : map.goal_i);};
+    auto column = [&](int v) {return v < n ? graph->columns[v] : (v == startNode ? map.start_j : map.goal_j);};
+    auto cost = [&](int v, int w) {return graph->metric(row(v) - row(w), column(v) - column(w));};
+    auto relax = [&](int v, int w) {
+        double g = dist[v] + cost(v, w);
+        if (closed[w] || g >= dist[w])
+            return;
+        if (dist[w] == infinity)
+            touched.push_back(w);
+        dist[w] = g;
+        parent[w] = v;
+        queue.push_back(Entry(g + cost(w, goalNode), w));
+        std::push_heap(queue.begin(), queue.end(), std::greater<Entry>());
+    };
+    bool pathfound = false;
+    touched.clear();
+    startLinks.clear();
+    goalLinks.clear();
+    if (map.CellIsTraversable(map.start_i, map.start_j) && map.CellIsTraversable(map.goal_i, map.goal_j)) {
+        bool direct = graph->reach(map, map.start_i, map.start_j, goalCell, startLinks, sweep);
+        if (startCell == goalCell || direct)
+            startLinks.push_back(goalNode);
+        graph->reach(map, map.goal_i, map.goal_j, -1, goalLinks, sweep);
+        if (graph->node[goalCell] >= 0)
+            goalLinks.push_back(graph->node[goalCell]);
+        //The links up from the local subgoals the goal reaches, and up from these, are followed down for this search
+        goalSide.clear();
+        for (std::size_t k = 0; k < goalLinks.size(); k++)
+            toGoal[goalLinks[k]] |= 1;
+        up.clear();
+        for (std::size_t k = 0; k < goalLinks.size(); k++)
+            if (graph->local[goalLinks[k]] && !closed[goalLinks[k]]) {
+                closed[goalLinks[k]] = 1;
+                up.push_back(goalLinks[k]);
+            }
+        for (std::size_t k = 0; k < up.size(); k++)
+            for (uint32_t l = graph->first[up[k]]; l < graph->first[up[k] + 1]; l++) {
+                int w = graph->links[l];
+                goalSide.push_back(std::make_pair(w, up[k]));
+                if (graph->local[w] && !closed[w]) {
+                    closed[w] = 1;
+                    up.push_back(w);
+                }
+            }
+        for (std::size_t k = 0; k < up.size(); k++)
+            closed[up[k]] = 0;
+        std::sort(goalSide.begin(), goalSide.end());
+        for (std::size_t k = 0; k < goalSide.size(); k++)
+            toGoal[goalSide[k].first] |= 2;
+        dist[startNode] = 0;
+        touched.push_back(startNode);
+        queue.assign(1, Entry(cost(startNode, goalNode), startNode));
+    }
+    while (!queue.empty()) {
+        std::pop_heap(queue.begin(), queue.end(), std::greater<Entry>());
+        int v = queue.back().second;
+        queue.pop_back();
+        if (closed[v])
+            continue;
+        closed[v] = 1;
+        if (v == goalNode) {
+            pathfound = true;
+            break;
+        }
+        sresult.numberofsteps++;
+        const int *begin = startLinks.data(), *stop = startLinks.data() + startLinks.size();
+        if (v < n) {
+            begin = graph->links.data() + graph->first[v];
+            stop = graph->links.data() + graph->first[v + 1];
+        }
+        for (const int *l = begin; l != stop; l++)
+            relax(v, *l);
+        if (v < n && (toGoal[v] & 1))
+            relax(v, goalNode);
+        if (v < n && (toGoal[v] & 2))
+            for (std::vector<std::pair<int, int>>::iterator l = std::lower_bound(goalSide.begin(), goalSide.end(), std::make_pair(v, -1));
+                    l != goalSide.end() && l->first == v; ++l)
+                relax(v, l->second);
+    }
+
+    //Nodes from the start to the goal, every link refined into moves
+    std::vector<int> nodes, path;
+    if (pathfound) {
+        for (int v = goalNode; v != startNode; v = parent[v])
+            nodes.push_back(v);
+        nodes.push_back(startNode);
+        std::reverse(nodes.begin(), nodes.end());
+        sresult.pathlength = dist[goalNode];
+    }
+    if (pathfound && !distanceonly) {
+        path.push_back(startCell);
+        for (std::size_t k = 1; k < nodes.size() && pathfound; k++) {
+            int v = nodes[k - 1], w = nodes[k];
+            if (row(v) != row(w) || column(v) != column(w))
+                pathfound = graph->refine(map, row(v), column(v), row(w), column(w), path, sweep);
+        }
+    }
+    sresult.nodescreated = static_cast<unsigned int>(touched.size());
+    for (std::size_t k = 0; k < touched.size(); k++) {
+        dist[touched[k]] = infinity;
+        closed[touched[k]] = 0;
+    }
+    for (std::size_t k = 0; k < goalLinks.size(); k++)
+        toGoal[goalLinks[k]] = 0;
+    for (std::size_t k = 0; k < goalSide.size(); k++)
+        toGoal[goalSide[k].first] = 0;
+    queue.clear();
+
+    if (pathfound && !distanceonly) {
+        Node curNode;
+        curNode.g = 0;
+        curNode.H = 0;
+        curNode.parent = -1;
+        for (std::size_t k = 0; k < path.size(); k++) {
+            int i = path[k] / map.width, j = path[k] % map.width;
+            if (k > 0) {
+                curNode.parent = curNode.i * map.width + curNode.j;
+                curNode.g += (i != curNode.i && j != curNode.j) ? sqrt(2) : 1;
+            }
+            curNode.i = i;
+            curNode.j = j;
+            curNode.F = curNode.g;
+            lppath.push_back(curNode);
+        }
+        sresult.pathlength = curNode.g;
+    }
+    sresult.pathfound = pathfound;
+    end = std::chrono::system_clock::now();
+    sresult.time = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / 1000000000;
+    sresult.time -= sresult.preprocessingtime;
+    if (pathfound && !distanceonly)
+        makeSecondaryPath();
+
+    sresult.hppath = &hppath;
+    sresult.lppath = &lppath;
+    return sresult;
+}
@@ -4,6 +4,14 @@ Theta::~Theta()
 }
 
 bool Theta::lineOfSight(int i1, int j1, int i2, int j2, const Map &map, bool cutcorners)
+{
+    if (cutcorners)
+        return lineOfSight<true>(i1, j1, i2, j2, map);
+    return lineOfSight<false>(i1, j1, i2, j2, map);
+}
+
+template <bool CutCorners>
+bool Theta::lineOfSight(int i1, int j1, int i2, int j2, const Map &map)
 {
     int delta_i = std::abs(i1 - i2);
     int delta_j = std::abs(j1 - j2);
@@ -24,7 +32,7 @@ bool Theta::lineOfSight(int i1, int j1, int i2, int j2, const Map &map, bool cut
                 return false;
         return true;
     }
-    if(cutcorners) {
+    if(CutCorners) {
         if (delta_i > delta_j) {
             for (; i != i2; i += step_i) {
                 if (map.CellIsObstacle(i, j))
@@ -105,14 +113,19 @@ bool Theta::lineOfSight(int i1, int j1, int i2, int j2, const Map &map, bool cut
     return true;
 }
 
+template bool Theta::lineOfSight<true>(int i1, int j1, int i2, int j2, const Map &map);
+template bool Theta::lineOfSight<false>(int i1, int j1, int i2, int j2, const Map &map);
+
 Node Theta::resetParent(Node current, Node parent, const Map &map, const EnvironmentOptions &options )
 {
-    if (parent.parent == nullptr)
+    if (parent.parent < 0)
         return current;
-    if(current == *parent.parent)
+    Node grandparent = cells.node(parent.parent);
+    if(current == grandparent)
         return current;
-    if (lineOfSight(parent.parent->i, parent.parent->j, current.i, current.j, map, options.cutcorners)) {
-        current.g = parent.parent->g + distance(parent.parent->i, parent.parent->j, current.i, current.j);
+    sresult.lineofsightchecks++;
+    if (lineOfSight(grandparent.i, grandparent.j, current.i, current.j, map, options.cutcorners)) {
+        current.g = grandparent.g + distance(grandparent.i, grandparent.j, current.i, current.j);
         current.parent = parent.parent;
         return current;
     }
@@ -177,9 +190,9 @@ void Theta::makeSecondaryPath()
 void Theta::makePrimaryPath(Node curNode)
 {
     Node current = curNode;
-    while(current.parent) {
+    while(current.parent >= 0) {
         hppath.push_front(current);
-        current = *current.parent;
+        current = cells.node(current.parent);
     }
     hppath.push_front(current);
 }
@@ -0,0 +1,89 @@
+#include "threadpool.h"
+#include <thread>
+#include <algorithm>
+
+ThreadPool::ThreadPool(int threads)
+{
+    if (threads <= 0)
+        threads = static_cast<int>(std::thread::hardware_concurrency());
+    this->threads = (threads > 0 ? threads : 1);
+    for (int k = 0; k < this->threads; k++)
+        ranges.push_back(std::unique_ptr<Range>(new Range()));
+}
+
+void ThreadPool::run(int count, const std::function<void(int, int)> &task)
+{
+    if (count <= 0)
+        return;
+    int workers = std::min(threads, count);
+    for (int k = 0; k < threads; k++) {
+        ranges[k]->begin = (k < workers ? static_cast<int>(static_cast<long long>(count) * k / workers) : count);
+        ranges[k]->end = (k < workers ? static_cast<int>(static_cast<long long>(count) * (k + 1) / workers) : count);
+    }
+    error = nullptr;
+    std::vector<std::thread> pool;
+    for (int k = 1; k < workers; k++)
+        pool.emplace_back(&ThreadPool::work, this, k, std::cref(task));
+    work(0, task);
+    for (std::size_t k = 0; k < pool.size(); k++)
+        pool[k].join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ThreadPool::work(int worker, const std::function<void(int, int)> &task)
+{
+    int index;
+    while (next(worker, index)) {
+        try {
+            task(worker, index);
+        }
+        catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+}
+
+bool ThreadPool::next(int worker, int &index)
+{
+    Range &own = *ranges[worker];
+    {
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (own.begin < own.end) {
+            index = own.begin++;
+            return true;
+        }
+    }
+    while (true) {
+        //The sizes may change before the steal, so the victim's block is checked again under its lock
+        int victim = -1, largest = 0;
+        for (int k = 0; k < threads; k++) {
+            if (k == worker)
+                continue;
+            std::lock_guard<std::mutex> lock(ranges[k]->mutex);
+            if (ranges[k]->end - ranges[k]->begin > largest) {
+                largest = ranges[k]->end - ranges[k]->begin;
+                victim = k;
+            }
+        }
+        if (victim < 0)
+            return false;
+        Range &other = *ranges[victim];
+        int begin, end;
+        {
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (other.begin >= other.end)
+                continue;
+            end = other.end;
+            begin = other.begin + (other.end - other.begin) / 2;
+            other.end = begin;
+        }
+        std::lock_guard<std::mutex> lock(own.mutex);
+        index = begin;
+        own.begin = begin + 1;
+        own.end = end;
+        return true;
+    }
+}
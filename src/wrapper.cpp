@@ -1,100 +1,34 @@
-#include "mission.h"
-#include <chrono>
+#include "planner.h"
 #include "wrapper.h"
 
 // using namespace JPS; // Removed as JPS namespace is not defined or used by plan_2d related components
 
-class Timer {
-    typedef std::chrono::high_resolution_clock high_resolution_clock;
-    typedef std::chrono::milliseconds milliseconds;
-    public:
-    explicit Timer(bool run = false)
-    {
-        if (run)
-        Reset();
-    }
-    void Reset()
-    {
-        _start = high_resolution_clock::now();
-    }
-    milliseconds Elapsed() const
-    {
-        return std::chrono::duration_cast<milliseconds>(high_resolution_clock::now() - _start);
-    }
-    private:
-    high_resolution_clock::time_point _start;
-};
-
 int plan_2d(std::vector<float> &origin, std::vector<int> &dim, std::vector<signed char> &map, std::vector<float> &start, std::vector<float> &goal, float resolution, std::vector<std::vector<double> > &path, double &time_spent, bool use_theta)
 {
-    std::vector<std::vector<int>> map_grid;
-    int height = dim[1];
-    int width = dim[0];
-    map_grid.resize(height);
-    for (int i = 0; i < height; ++i)
-    {
-        map_grid[i].resize(width);
-        for (int j = 0; j < width; ++j)
-        {
-            map_grid[i][j] = map[i * width + j];
-        }
-    }
-    int start_x = static_cast<int>((start[0] - origin[0]) / resolution);
-    int start_y = static_cast<int>((start[1] - origin[1]) / resolution);
-    int goal_x = static_cast<int>((goal[0] - origin[0]) / resolution);
-    int goal_y = static_cast<int>((goal[1] - origin[1]) / resolution);
+    return plan_2d(origin, dim, map, start, goal, resolution, path, time_spent, std::string(use_theta ? CNS_SP_ST_TH : CNS_SP_ST_ASTAR));
+}
 
-    if (start_x < 0 || start_x >= width || start_y < 0 || start_y >= height ||
-        goal_x < 0 || goal_x >= width || goal_y < 0 || goal_y >= height)
-    {
-        return -1; // Invalid start or goal position
-    }
-
-    Mission mission;
-    int cellSize = resolution;
-    if (!mission.getMap(start_x, start_y, goal_x, goal_y, cellSize, map_grid))
-    {
-        return -1; // Failed to get the map
-    }
+int plan_2d(std::vector<float> &origin, std::vector<int> &dim, std::vector<signed char> &map, std::vector<float> &start, std::vector<float> &goal, float resolution, std::vector<std::vector<double> > &path, double &time_spent, const std::string &searchtype)
+{
+    std::vector<double> points;
+    int status = plan_2d(origin, dim, map.data(), map.size(), start, goal, resolution, points, time_spent, searchtype);
+    path.clear();
+    for (size_t k = 0; k + 1 < points.size(); k += 2)
+        path.push_back({points[k], points[k + 1]});
+    return status;
+}
 
-    if (use_theta)
+int plan_2d(const std::vector<float> &origin, const std::vector<int> &dim, const signed char *map, std::size_t map_size, const std::vector<float> &start, const std::vector<float> &goal, double resolution, std::vector<double> &path, double &time_spent, const std::string &searchtype,
+            const std::map<std::string, std::string> &options)
+{
+    path.clear();
+    Planner planner(origin, dim, map, map_size, resolution);
+    if (!planner.isLoaded())
     {
-        Timer time_theta(true);
-        mission.setDefaultConfig(true); // Set default configuration for Theta*
-        mission.createEnvironmentOptions();
-        mission.createSearch();
-        mission.startSearch();
-        double dt_theta = time_theta.Elapsed().count();
-        std::vector<std::vector<int>> path_int;
-        mission.getPath(path_int); // Get the path from the mission
-        path.clear();
-        for (const auto &pt : path_int)
-        {
-            double x = origin[0] + pt[0] * cellSize;
-            double y = origin[1] + pt[1] * cellSize;
-            path.push_back({x, y});
-        }
-        time_spent = dt_theta;
-        return mission.getPathValid() ? 0 : -1; // Return 0 if the path is valid
-    }
-    else{
-        Timer time_astar(true);
-        mission.setDefaultConfig(false); // Set default configuration for A*
-        mission.createEnvironmentOptions();
-        mission.createSearch();
-        mission.startSearch();
-        double dt_astar = time_astar.Elapsed().count();
-        std::vector<std::vector<int>> path_int;
-        mission.getPath(path_int); // Get the path from the mission
-        path.clear();
-        for (const auto &pt : path_int)
-        {
-            double x = origin[0] + pt[0] * cellSize;
-            double y = origin[1] + pt[1] * cellSize;
-            path.push_back({x, y});
-        }
-        time_spent = dt_astar;
-        return mission.getPathValid() ? 0 : -1; // Return 0 if the path is valid
+        return -1; // Malformed arguments or map buffer
     }
-    return 0;
-}
\ No newline at end of file
+    planner.setComponentCheck(false); // The labels would cost as much as the search they might save
+    Planner::Options query(options);
+    query[CNS_TAG_ST] = searchtype;
+    return planner.plan(start, goal, query, path, time_spent);
+}